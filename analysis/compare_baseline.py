@@ -0,0 +1,57 @@
+import argparse
+import json
+import sys
+
+KEY = ('isa', 'impl', 'type', 'm', 'n', 'k', 'threads')
+
+
+def load(file_path):
+    with open(file_path) as f:
+        data = json.load(f)
+    # isa is recorded once per run in the context; a result may carry its own
+    # when files from several binaries are merged
+    isa = data.get('context', {}).get('isa', '?')
+    return {tuple(r.get(k, isa) if k == 'isa' else r[k] for k in KEY): r for r in data['results']}
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Flag GOps regressions against a stored gemm_sweep baseline.')
+    parser.add_argument('baseline', help='baseline gemm_sweep JSON')
+    parser.add_argument('current', help='current gemm_sweep JSON')
+    parser.add_argument('--threshold', type=float, default=0.05,
+                        help='relative GOps drop tolerated as noise (default 0.05)')
+    args = parser.parse_args()
+
+    baseline = load(args.baseline)
+    current = load(args.current)
+
+    regressions = 0
+    unusable = 0
+    print(f"{'ISA':>5} {'IMPL':>16} {'TYPE':>4} {'SHAPE':>16} {'T':>3} {'BASE':>10} {'NOW':>10} {'DELTA':>8}")
+    for key in sorted(baseline.keys() & current.keys()):
+        isa, impl, type_, m, n, k, threads = key
+        base = baseline[key]['gops']
+        now = current[key]['gops']
+        if base <= 0:
+            unusable += 1
+            print(f'{isa:>5} {impl:>16} {type_:>4} {f"{m}x{n}x{k}":>16} {threads:>3} {base:10.3f} {now:10.3f} {"n/a":>8}  NO BASELINE')
+            continue
+        delta = (now - base) / base
+        flag = ''
+        if delta < -args.threshold:
+            flag = '  REGRESSION'
+            regressions += 1
+        print(f'{isa:>5} {impl:>16} {type_:>4} {f"{m}x{n}x{k}":>16} {threads:>3} {base:10.3f} {now:10.3f} {delta:+8.1%}{flag}')
+
+    missing = baseline.keys() - current.keys()
+    if missing:
+        print(f'{len(missing)} baseline point(s) missing from current run')
+    if unusable:
+        print(f'{unusable} baseline point(s) with zero GOps skipped')
+
+    print(f'{regressions} regression(s) beyond {args.threshold:.0%}')
+    sys.exit(1 if regressions else 0)
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,40 @@
+import json
+import pandas as pd
+
+
+def _label(df):
+    # Split series by element type / thread count only when a file mixes them
+    label = df['Method']
+    for column, prefix in (('Type', ''), ('Threads', 't=')):
+        if column in df and df[column].nunique() > 1:
+            label = label + ' ' + prefix + df[column].astype(str)
+    return label
+
+
+def load_results(file_path):
+    """Load gemm_sweep JSON/CSV or a google-benchmark CSV into one frame.
+
+    Columns: Method, Size, GOps, plus Type, Threads, M, N, K for sweep output.
+    Size is the cube root of M*N*K, i.e. N for square shapes.
+    """
+    if file_path.endswith('.json'):
+        with open(file_path) as f:
+            df = pd.DataFrame(json.load(f)['results'])
+    else:
+        df = pd.read_csv(file_path)
+
+    if 'impl' in df:
+        df = df.rename(columns={
+            'impl': 'Method', 'type': 'Type', 'threads': 'Threads',
+            'm': 'M', 'n': 'N', 'k': 'K', 'gops': 'GOps',
+        })
+        df['Size'] = (df['M'] * df['N'] * df['K']) ** (1.0 / 3.0)
+    else:
+        pattern = r'([a-zA-Z0-9_ ]+)/(\d+)'
+        extracted = df['name'].str.extract(pattern)
+        df['Method'] = extracted[0]
+        df['Size'] = extracted[1].astype(float)
+        df = df.dropna(subset=['Size'])
+
+    df['Series'] = _label(df)
+    return df
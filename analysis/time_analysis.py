@@ -2,22 +2,17 @@ import pandas as pd
 import matplotlib.pyplot as plt
 import seaborn as sns
 import sys
-import re
+
+from load_results import load_results
 
 file_path = "results.csv" if len(sys.argv) < 2 else sys.argv[1]
 
 try:
-    df = pd.read_csv(file_path)
+    df = load_results(file_path)
 except Exception as e:
-    print(f"Error reading CSV: {e}")
+    print(f"Error reading results: {e}")
     sys.exit(1)
 
-pattern = r'([a-zA-Z0-9_]+)/(\d+)'
-df[['Method', 'Size']] = df['name'].str.extract(pattern)
-df['Size'] = df['Size'].astype(int)
-
-df = df.dropna(subset=['Size'])
-
 plt.figure(figsize=(12, 7))
 sns.set_theme(style="whitegrid")
 
@@ -27,8 +22,8 @@ sns.lineplot(
     data=df,
     x='Size',
     y=y_axis,
-    hue='Method',
-    style='Method',
+    hue='Series',
+    style='Series',
     markers=True,
     dashes=False,
     linewidth=2.5,
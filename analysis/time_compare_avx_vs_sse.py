@@ -3,27 +3,22 @@ import matplotlib.pyplot as plt
 import seaborn as sns
 import sys
 
+from load_results import load_results
+
 def load_and_preprocess(file_path, label):
     try:
-        df = pd.read_csv(file_path)
+        df = load_results(file_path)
     except Exception as e:
         print(f"Error reading {file_path}: {e}")
         return None
 
-    # Extract Method and Size from the 'name' column
-    # Pattern handles formats like "Simd/2048"
-    pattern = r'([a-zA-Z0-9_]+)/(\d+)'
-    extracted = df['name'].str.extract(pattern)
-    df['Method'] = extracted[0]
-    df['Size'] = extracted[1].astype(float) # float handles scientific notation better
-    
     # Add the Variant tag (SSE vs AVX)
     df['Variant'] = label
     
     # Create a combined Label for the legend
-    df['Implementation'] = df['Method'] + " (" + df['Variant'] + ")"
+    df['Implementation'] = df['Series'] + " (" + df['Variant'] + ")"
     
-    return df.dropna(subset=['Size'])
+    return df
 
 # Usage check
 if len(sys.argv) < 3:
@@ -53,7 +48,7 @@ sns.lineplot(
     data=df_total,
     x='Size',
     y=y_axis,
-    hue='Method',
+    hue='Series',
     style='Variant', 
     markers=True,
     markersize=8,
@@ -1,35 +1,121 @@
 #include "mat.hpp"
+#include "roofline.hpp"
 #include <benchmark/benchmark.h>
+#include <array>
+#include <chrono>
 #include <cmath> 
+#include <optional>
+#include <print>
+#include <string_view>
 
-template <std::size_t N, Impl IMPLEMENTATION>
+// Set by --roofline before any benchmark runs.
+static std::optional<roofline::MachinePeaks> machine_peaks;
+
+template <typename T>
+void add_roofline_counters(
+    benchmark::State& state, 
+    std::size_t N, 
+    Impl implementation, 
+    double elapsed_seconds
+) {
+    const auto& peaks = *machine_peaks;
+    const std::size_t llc = peaks.levels[2].bytes;
+    const auto& level = peaks.level_for(3 * N * N * sizeof(T));
+
+    const double ops = 2.0 * std::pow(N, 3);
+    const double ai = roofline::arithmetic_intensity<T>(implementation, N, llc);
+    const double attainable = std::min(peaks.gops, ai * level.gbs);
+    const double achieved = ops * state.iterations() / elapsed_seconds * 1e-9;
+
+    state.counters["AI"] = ai;
+    state.counters["BwBound"] = ai < peaks.ridge(level) ? 1 : 0;
+    state.counters["PctPeak"] = achieved / peaks.gops * 100.0;
+    state.counters["PctRoof"] = achieved / attainable * 100.0;
+}
+
+template <std::size_t N, Impl IMPLEMENTATION, typename Layout = layout::RowMajor>
 void RunBenchmark(benchmark::State& state) {
-    static auto a = SquareMatrix<std::int32_t, N>::make_random(1, 10);
-    static auto b = SquareMatrix<std::int32_t, N>::make_random(1, 10);
+    static auto a = SquareMatrix<std::int32_t, N, Layout>::make_random(1, 10);
+    static auto b = SquareMatrix<std::int32_t, N, Layout>::make_random(1, 10);
 
-    SquareMatrix<std::int32_t, N> result{};
+    SquareMatrix<std::int32_t, N, Layout> result{};
+    const auto start = std::chrono::steady_clock::now();
     for (auto _ : state) {
         a.multiply(b, result, IMPLEMENTATION);
         benchmark::DoNotOptimize(result);
         benchmark::ClobberMemory();
     }
+    const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
 
     double ops = 2.0 * std::pow(N, 3);
     
     state.counters["GOps"] = benchmark::Counter(
         ops, 
-        benchmark::Counter::kIsRate,
+        benchmark::Counter::kIsIterationInvariantRate,
         benchmark::Counter::kIs1000
     );
     
     double bytes = 3.0 * std::pow(N, 2) * sizeof(std::int32_t);
     state.counters["Bandwidth"] = benchmark::Counter(
         bytes, 
-        benchmark::Counter::kIsRate | benchmark::Counter::kAvgThreads,
+        benchmark::Counter::kIsIterationInvariantRate | benchmark::Counter::kAvgThreads,
+        benchmark::Counter::kIs1000
+    );
+
+    if (machine_peaks)
+        add_roofline_counters<std::int32_t>(state, N, IMPLEMENTATION, elapsed.count());
+}
+
+// Effective GFLOPS of the solvers: the textbook flop count of the
+// operation over the wall time, so the figures compare directly with
+// 2 * N^3 for a multiply of the same size.
+template <std::size_t N>
+void RunLuBenchmark(benchmark::State& state) {
+    static auto a = SquareMatrix<double, N>::make_random(-9, 9);
+
+    SquareMatrix<double, N> factors{};
+    std::array<std::size_t, N> pivots{};
+    for (auto _ : state) {
+        a.lu(factors, pivots);
+        benchmark::DoNotOptimize(factors);
+        benchmark::ClobberMemory();
+    }
+
+    state.counters["GFLOPS"] = benchmark::Counter(
+        2.0 / 3.0 * std::pow(N, 3),
+        benchmark::Counter::kIsIterationInvariantRate,
         benchmark::Counter::kIs1000
     );
 }
 
+template <std::size_t N>
+void RunTrsmBenchmark(benchmark::State& state) {
+    static auto a = SquareMatrix<double, N>::make_random(-9, 9);
+    static auto b = SquareMatrix<double, N>::make_random(-9, 9);
+    static SquareMatrix<double, N> factors{};
+    static std::array<std::size_t, N> pivots{};
+    a.lu(factors, pivots);
+
+    for (auto _ : state) {
+        state.PauseTiming();
+        auto x = b;
+        state.ResumeTiming();
+        factors.trsm(x, Triangle::LOWER, Diagonal::UNIT);
+        benchmark::DoNotOptimize(x);
+        benchmark::ClobberMemory();
+    }
+
+    state.counters["GFLOPS"] = benchmark::Counter(
+        std::pow(N, 3),
+        benchmark::Counter::kIsIterationInvariantRate,
+        benchmark::Counter::kIs1000
+    );
+}
+
+#define REGISTER_SOLVERS(N) \
+    BENCHMARK(RunLuBenchmark<N>)   ->Name("LU/" #N); \
+    BENCHMARK(RunTrsmBenchmark<N>) ->Name("TRSM/" #N);
+
 #define REGISTER_SIZE(N) \
     BENCHMARK(RunBenchmark<N, Impl::NAIVE>)           ->Name("Naive/" #N); \
     BENCHMARK(RunBenchmark<N, Impl::TRANSPOSED>)      ->Name("Tranposed/" #N); \
@@ -45,7 +131,12 @@ void RunBenchmark(benchmark::State& state) {
     BENCHMARK(RunBenchmark<N, Impl::TILED>)           ->Name("Tiled/" #N); \
     BENCHMARK(RunBenchmark<N, Impl::TILED_SIMD>)      ->Name("Tiled SIMD/" #N); \
     BENCHMARK(RunBenchmark<N, Impl::TILED_PREFETCH>)  ->Name("Tiled PREFETCH/" #N); \
-    BENCHMARK(RunBenchmark<N, Impl::TILED_REGISTERS>)  ->Name("Tiled REGISTERS/" #N); 
+    BENCHMARK(RunBenchmark<N, Impl::TILED_REGISTERS>)  ->Name("Tiled REGISTERS/" #N); \
+    REGISTER_TILED_LAYOUTS(N)
+
+#define REGISTER_TILED_LAYOUTS(N) \
+    BENCHMARK(RunBenchmark<N, Impl::TILED_REGISTERS, layout::BlockMajor>) ->Name("Tiled REGISTERS BlockMajor/" #N); \
+    BENCHMARK(RunBenchmark<N, Impl::TILED_REGISTERS, layout::Morton>)     ->Name("Tiled REGISTERS Morton/" #N);
 
 
 // REGISTER_SIZE(4);
@@ -57,11 +148,49 @@ REGISTER_SIZE(128);
 REGISTER_SIZE(256);
 REGISTER_SIZE(512);
 REGISTER_LARGE_SIZE(1024);
+BENCHMARK(RunBenchmark<1032, Impl::TILED_REGISTERS>)->Name("Tiled REGISTERS/1032");
+REGISTER_TILED_LAYOUTS(1032);
 REGISTER_LARGE_SIZE(2048);
 REGISTER_LARGE_SIZE(4096);
 REGISTER_LARGE_SIZE(8192);
 
-BENCHMARK_MAIN();
+REGISTER_SOLVERS(256);
+REGISTER_SOLVERS(512);
+REGISTER_SOLVERS(1024);
+REGISTER_SOLVERS(2048);
+
+void print_machine_peaks(const roofline::MachinePeaks& peaks) {
+    std::println("Peak multiply-add throughput: {:.2f} GOps/s", peaks.gops);
+    std::println("| {:5} | {:>12} | {:>10} | {:>12} |", "LEVEL", "BYTES", "GB/s", "RIDGE Ops/B");
+    for (const auto& level: peaks.levels) {
+        std::println("| {:5} | {:>12} | {:>10.2f} | {:>12.2f} |", 
+            level.name, level.bytes, level.gbs, peaks.ridge(level)
+        );
+    }
+}
+
+int main(int argc, char** argv) {
+    // --roofline: measure the host first, then add AI / PctPeak / PctRoof / 
+    // BwBound counters to every run.
+    int kept = 1;
+    for (int i = 1; i < argc; ++i) {
+        if (std::string_view(argv[i]) == "--roofline")
+            machine_peaks = roofline::measure_machine<std::int32_t>();
+        else
+            argv[kept++] = argv[i];
+    }
+    argc = kept;
+
+    if (machine_peaks)
+        print_machine_peaks(*machine_peaks);
+
+    benchmark::Initialize(&argc, argv);
+    if (benchmark::ReportUnrecognizedArguments(argc, argv))
+        return 1;
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+    return 0;
+}
 
 
 /*
@@ -0,0 +1,330 @@
+#include "matrix.hpp"
+
+#include <algorithm>
+#include <charconv>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <optional>
+#include <print>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Runtime-configured GEMM sweep over shapes, Impls, thread counts and element
+// types. Results go out as JSON or CSV for analysis/*.py; see
+// analysis/compare_baseline.py for regression checks against a stored run.
+
+struct Shape {
+    std::size_t m;  // rows of A and C
+    std::size_t n;  // cols of B and C
+    std::size_t k;  // inner dimension
+};
+
+struct Options {
+    std::vector<Shape> shapes;
+    std::vector<Impl> impls = {Impl::TILED_REGISTERS};
+    std::vector<std::size_t> threads = {1};
+    std::vector<std::string> types = {"f32"};
+    double min_time = 0.5;
+    std::size_t repeats = 3;
+    bool csv = false;
+    std::string out;
+};
+
+struct Result {
+    std::string_view impl;
+    std::string_view type;
+    Shape shape;
+    std::size_t threads;
+    std::size_t runs;
+    double median_seconds;
+    double min_seconds;
+    double gops;
+};
+
+constexpr auto IMPL_NAMES = std::to_array<std::pair<Impl, std::string_view>>({
+    {Impl::NAIVE,           "naive"},
+    {Impl::TRANSPOSED,      "transposed"},
+    {Impl::TRANSPOSED_SIMD, "transposed_simd"},
+    {Impl::TILED,           "tiled"},
+    {Impl::TILED_SIMD,      "tiled_simd"},
+    {Impl::TILED_PREFETCH,  "tiled_prefetch"},
+    {Impl::TILED_REGISTERS, "tiled_registers"},
+    {Impl::AUTO,            "auto"},
+});
+
+constexpr std::string_view impl_name(Impl implementation) {
+    for (const auto& [impl, name]: IMPL_NAMES)
+        if (impl == implementation)
+            return name;
+    return "unknown";
+}
+
+constexpr std::string_view ISA =
+#if defined(__AVX2__)
+    "avx2";
+#elif defined(__SSE2__)
+    "sse2";
+#else
+    "scalar";
+#endif
+
+// =================================================================
+// SECTION: ARGUMENTS
+// =================================================================
+
+std::vector<std::string_view> split(std::string_view list, char delimiter) {
+    std::vector<std::string_view> parts;
+    while (!list.empty()) {
+        const auto end = std::min(list.find(delimiter), list.size());
+        parts.push_back(list.substr(0, end));
+        list.remove_prefix(std::min(end + 1, list.size()));
+    }
+    return parts;
+}
+
+std::optional<std::size_t> parse_size(std::string_view text) {
+    std::size_t value{};
+    const auto [ptr, ec] = std::from_chars(text.data(), text.data() + text.size(), value);
+    if (ec != std::errc{} || ptr != text.data() + text.size())
+        return std::nullopt;
+    return value;
+}
+
+// A positive, finite number of seconds.
+std::optional<double> parse_seconds(std::string_view text) {
+    double value{};
+    const auto [ptr, ec] = std::from_chars(text.data(), text.data() + text.size(), value);
+    if (ec != std::errc{} || ptr != text.data() + text.size() || !std::isfinite(value) || value <= 0.0)
+        return std::nullopt;
+    return value;
+}
+
+// N, MxNxK or START:END[:STEP] (square sizes, END inclusive)
+bool parse_shapes(std::string_view list, std::vector<Shape>& shapes) {
+    for (auto token: split(list, ',')) {
+        if (token.find(':') != std::string_view::npos) {
+            const auto parts = split(token, ':');
+            const auto start = parse_size(parts[0]);
+            const auto end   = parts.size() > 1 ? parse_size(parts[1]) : std::nullopt;
+            const auto step  = parts.size() > 2 ? parse_size(parts[2]) : std::optional<std::size_t>{1};
+            if (!start || !end || !step || *step == 0)
+                return false;
+            for (std::size_t n = *start; n <= *end; n += *step)
+                shapes.push_back({n, n, n});
+        } else if (token.find('x') != std::string_view::npos) {
+            const auto parts = split(token, 'x');
+            if (parts.size() != 3)
+                return false;
+            const auto m = parse_size(parts[0]);
+            const auto n = parse_size(parts[1]);
+            const auto k = parse_size(parts[2]);
+            if (!m || !n || !k)
+                return false;
+            shapes.push_back({*m, *n, *k});
+        } else {
+            const auto n = parse_size(token);
+            if (!n)
+                return false;
+            shapes.push_back({*n, *n, *n});
+        }
+    }
+    return true;
+}
+
+void print_usage() {
+    std::println("Usage: gemm_sweep --shapes LIST [options]");
+    std::println("  --shapes  LIST   N | MxNxK | START:END[:STEP], comma separated");
+    std::println("  --impls   LIST   naive,tiled_registers (default tiled_registers)");
+    std::println("  --threads LIST   thread counts (default 1)");
+    std::println("  --types   LIST   i32,f32,f64,bf16,fp16 (default f32)");
+    std::println("  --min-time S     minimum measured seconds per point (default 0.5)");
+    std::println("  --repeats R      minimum runs per point (default 3)");
+    std::println("  --format  F      json | csv (default json)");
+    std::println("  --out     PATH   output file (default stdout)");
+}
+
+std::optional<Options> parse_options(int argc, char** argv) {
+    Options options;
+    for (int i = 1; i < argc; ++i) {
+        const std::string_view flag = argv[i];
+        if (i + 1 >= argc)
+            return std::nullopt;
+        const std::string_view value = argv[++i];
+
+        if (flag == "--shapes") {
+            if (!parse_shapes(value, options.shapes))
+                return std::nullopt;
+        } else if (flag == "--impls") {
+            options.impls.clear();
+            for (auto name: split(value, ',')) {
+                const auto it = std::ranges::find(IMPL_NAMES, name, &std::pair<Impl, std::string_view>::second);
+                if (it == IMPL_NAMES.end() || !Matrix<float>::supports(it->first))
+                    return std::nullopt;
+                options.impls.push_back(it->first);
+            }
+        } else if (flag == "--threads") {
+            options.threads.clear();
+            for (auto count: split(value, ',')) {
+                const auto threads = parse_size(count);
+                if (!threads || *threads == 0)
+                    return std::nullopt;
+                options.threads.push_back(*threads);
+            }
+        } else if (flag == "--types") {
+            options.types.clear();
+            for (auto type: split(value, ',')) {
+                if (type != "i32" && type != "f32" && type != "f64" && type != "bf16" && type != "fp16")
+                    return std::nullopt;
+                options.types.emplace_back(type);
+            }
+        } else if (flag == "--min-time") {
+            const auto min_time = parse_seconds(value);
+            if (!min_time)
+                return std::nullopt;
+            options.min_time = *min_time;
+        } else if (flag == "--repeats") {
+            const auto repeats = parse_size(value);
+            if (!repeats || *repeats == 0)
+                return std::nullopt;
+            options.repeats = *repeats;
+        } else if (flag == "--format") {
+            if (value != "json" && value != "csv")
+                return std::nullopt;
+            options.csv = value == "csv";
+        } else if (flag == "--out") {
+            options.out = value;
+        } else {
+            return std::nullopt;
+        }
+    }
+
+    if (options.shapes.empty())
+        return std::nullopt;
+    return options;
+}
+
+// =================================================================
+// SECTION: MEASUREMENT
+// =================================================================
+
+template<typename T>
+void sweep_type(const Options& options, std::string_view type, std::vector<Result>& results) {
+    using clock = std::chrono::steady_clock;
+
+    for (const auto& shape: options.shapes) {
+        const auto a = Matrix<T>::make_random(shape.m, shape.k, static_cast<T>(1), static_cast<T>(10));
+        const auto b = Matrix<T>::make_random(shape.k, shape.n, static_cast<T>(1), static_cast<T>(10));
+        Matrix<T> c(shape.m, shape.n);
+
+        for (Impl implementation: options.impls) {
+            for (std::size_t threads: options.threads) {
+                // Serial kernels are measured once, not once per thread count.
+                const bool threaded = implementation == Impl::TILED_REGISTERS || implementation == Impl::AUTO;
+                if (!threaded && threads != options.threads.front())
+                    continue;
+                const std::size_t effective_threads = threaded ? threads : 1;
+
+                a.multiply(b, c, implementation, effective_threads); // warm-up
+
+                std::vector<double> times;
+                double total = 0.0;
+                while (times.size() < options.repeats || total < options.min_time) {
+                    const auto start = clock::now();
+                    a.multiply(b, c, implementation, effective_threads);
+                    const std::chrono::duration<double> elapsed = clock::now() - start;
+                    times.push_back(elapsed.count());
+                    total += elapsed.count();
+                }
+
+                std::ranges::sort(times);
+                const double median = times[times.size() / 2];
+                const double ops = 2.0 * shape.m * shape.n * shape.k;
+
+                results.push_back({
+                    .impl = impl_name(implementation),
+                    .type = type,
+                    .shape = shape,
+                    .threads = effective_threads,
+                    .runs = times.size(),
+                    .median_seconds = median,
+                    .min_seconds = times.front(),
+                    .gops = ops / median * 1e-9,
+                });
+                std::println(stderr, "{:>16} {} {}x{}x{} t={} : {:.3f} GOps/s",
+                    results.back().impl, type, shape.m, shape.n, shape.k,
+                    effective_threads, results.back().gops
+                );
+            }
+        }
+    }
+}
+
+// =================================================================
+// SECTION: OUTPUT
+// =================================================================
+
+void write_csv(std::FILE* out, const std::vector<Result>& results) {
+    std::println(out, "isa,impl,type,m,n,k,threads,runs,median_seconds,min_seconds,gops");
+    for (const auto& r: results) {
+        std::println(out, "{},{},{},{},{},{},{},{},{:.9f},{:.9f},{:.6f}",
+            ISA, r.impl, r.type, r.shape.m, r.shape.n, r.shape.k,
+            r.threads, r.runs, r.median_seconds, r.min_seconds, r.gops
+        );
+    }
+}
+
+void write_json(std::FILE* out, const std::vector<Result>& results) {
+    std::println(out, "{{");
+    std::println(out, "  \"context\": {{\"isa\": \"{}\", \"simd_width\": {}, \"register_tile\": {}}},",
+        ISA, kernels::SIMD_SIZE, kernels::REGISTER_TILE
+    );
+    std::println(out, "  \"results\": [");
+    for (std::size_t i{}; i < results.size(); ++i) {
+        const auto& r = results[i];
+        std::println(out,
+            "    {{\"impl\": \"{}\", \"type\": \"{}\", \"m\": {}, \"n\": {}, \"k\": {}, "
+            "\"threads\": {}, \"runs\": {}, \"median_seconds\": {:.9f}, "
+            "\"min_seconds\": {:.9f}, \"gops\": {:.6f}}}{}",
+            r.impl, r.type, r.shape.m, r.shape.n, r.shape.k, r.threads, r.runs,
+            r.median_seconds, r.min_seconds, r.gops, i + 1 < results.size() ? "," : ""
+        );
+    }
+    std::println(out, "  ]");
+    std::println(out, "}}");
+}
+
+int main(int argc, char** argv) {
+    const auto options = parse_options(argc, argv);
+    if (!options) {
+        print_usage();
+        return 1;
+    }
+
+    std::vector<Result> results;
+    for (const auto& type: options->types) {
+        if (type == "i32")      sweep_type<std::int32_t>(*options, "i32", results);
+        else if (type == "f32") sweep_type<float>(*options, "f32", results);
+        else if (type == "f64") sweep_type<double>(*options, "f64", results);
+        else if (type == "bf16") sweep_type<bf16>(*options, "bf16", results);
+        else if (type == "fp16") sweep_type<fp16>(*options, "fp16", results);
+    }
+
+    std::FILE* out = options->out.empty() ? stdout : std::fopen(options->out.c_str(), "w");
+    if (!out) {
+        std::println(stderr, "Cannot open {}", options->out);
+        return 1;
+    }
+
+    if (options->csv)
+        write_csv(out, results);
+    else
+        write_json(out, results);
+
+    if (out != stdout)
+        std::fclose(out);
+
+    return 0;
+}
@@ -241,5 +241,10 @@ int main() {
         perf_size<2 << 15>(); 
     }
 
+    if constexpr (trace::ENABLED) {
+        trace::write_chrome_trace("gemm_trace.json");
+        trace::write_histograms("gemm_trace_histograms.json");
+    }
+
     return 0;
 }
@@ -0,0 +1,117 @@
+#include "shm_transport.hpp"
+
+#include <charconv>
+#include <cstdio>
+#include <print>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <sys/wait.h>
+#include <unistd.h>
+
+// Runs one SUMMA multiply over a grid of forked ranks talking through POSIX
+// shared memory and prints, per panel, the slowest rank's communication and
+// compute time.
+//
+//   summa_driver [ROWSxCOLS] [MxNxK] [threads per rank]
+
+static std::vector<std::size_t> parse_dims(std::string_view text) {
+    std::vector<std::size_t> dims;
+    while (!text.empty()) {
+        std::size_t value{};
+        const auto [end, error] = std::from_chars(text.data(), text.data() + text.size(), value);
+        if (error != std::errc{})
+            return {};
+        dims.push_back(value);
+        text.remove_prefix(end - text.data());
+        if (!text.empty() && text.front() == 'x')
+            text.remove_prefix(1);
+    }
+    return dims;
+}
+
+int main(int argc, char** argv) {
+    const auto grid_dims = parse_dims(argc > 1 ? argv[1] : "2x2");
+    const auto shape = parse_dims(argc > 2 ? argv[2] : "1536x1536x1536");
+    const std::size_t threads = argc > 3 ? parse_dims(argv[3]).at(0) : 1;
+    if (grid_dims.size() != 2 || shape.size() != 3) {
+        std::println(stderr, "Usage: summa_driver [ROWSxCOLS] [MxNxK] [threads per rank]");
+        return 1;
+    }
+
+    const summa::Grid grid{grid_dims[0], grid_dims[1]};
+    const summa::Distribution distribution(grid, shape[0], shape[1], shape[2]);
+    const std::string name = "/gemm-summa-driver-" + std::to_string(getpid());
+    const std::size_t rounds = distribution.panels().size();
+
+    // Every rank reports its timings back through its own pipe.
+    std::vector<int> pipes;
+    std::vector<pid_t> children;
+    for (std::size_t rank{}; rank < grid.size(); ++rank) {
+        int fds[2];
+        if (pipe(fds) != 0) {
+            std::perror("pipe");
+            return 1;
+        }
+        const pid_t pid = fork();
+        if (pid != 0) {
+            close(fds[1]);
+            pipes.push_back(fds[0]);
+            children.push_back(pid);
+            continue;
+        }
+        close(fds[0]);
+
+        summa::ShmTransport transport(name, rank, grid.size(), distribution.max_message_bytes<float>());
+        const auto rows = distribution.c_rows(rank);
+        const auto cols = distribution.c_cols(rank);
+        const auto a_local = Matrix<float>::make_random(rows.size(), distribution.a_cols(rank).size(), -1.0f, 1.0f);
+        const auto b_local = Matrix<float>::make_random(distribution.b_rows(rank).size(), cols.size(), -1.0f, 1.0f);
+        Matrix<float> c_local(rows.size(), cols.size());
+
+        transport.barrier();
+        const auto timings = summa::multiply(transport, distribution, a_local, b_local, c_local, threads);
+        const auto bytes = timings.size() * sizeof(summa::RoundTiming);
+        const bool ok = write(fds[1], timings.data(), bytes) == static_cast<ssize_t>(bytes);
+        _exit(ok ? 0 : 1);
+    }
+
+    std::vector<std::vector<summa::RoundTiming>> timings(grid.size(), std::vector<summa::RoundTiming>(rounds));
+    bool ok = true;
+    for (std::size_t rank{}; rank < grid.size(); ++rank) {
+        auto* out = reinterpret_cast<char*>(timings[rank].data());
+        std::size_t remaining = rounds * sizeof(summa::RoundTiming);
+        for (ssize_t got; remaining > 0 && (got = read(pipes[rank], out, remaining)) > 0; out += got)
+            remaining -= got;
+        close(pipes[rank]);
+
+        int status{};
+        waitpid(children[rank], &status, 0);
+        ok = ok && remaining == 0 && WIFEXITED(status) && WEXITSTATUS(status) == 0;
+    }
+    if (!ok) {
+        std::println(stderr, "a rank failed");
+        return 1;
+    }
+
+    std::println("grid {}x{}, {}x{}x{} f32, {} thread(s) per rank, {} panels",
+        grid.rows, grid.cols, shape[0], shape[1], shape[2], threads, rounds);
+    std::println("| panel      | comm (ms) | compute (ms) |");
+
+    double total_communication{}, total_compute{};
+    for (std::size_t round{}; round < rounds; ++round) {
+        double communication{}, compute{};
+        for (const auto& rank_timings: timings) {
+            communication = std::max(communication, rank_timings[round].communication_seconds);
+            compute = std::max(compute, rank_timings[round].compute_seconds);
+        }
+        total_communication += communication;
+        total_compute += compute;
+
+        const auto k = timings[0][round].k;
+        std::println("| {:>4}:{:<5} | {:9.3f} | {:12.3f} |", k.begin, k.end, communication * 1e3, compute * 1e3);
+    }
+    std::println("| total      | {:9.3f} | {:12.3f} |", total_communication * 1e3, total_compute * 1e3);
+    return 0;
+}
@@ -1,92 +1,293 @@
 #include "mat.hpp"
+#include "matrix.hpp"
 
 #include <algorithm>
-#include <print>
 #include <array>
-#include <string_view>
-#include <cassert>
+#include <chrono>
 #include <cstdint>
+#include <cstdlib>
+#include <print>
+#include <random>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <utility>
+#include <vector>
 
-template<typename T, std::size_t N>
-bool validate_matrix_multiplication(
-    T lower_bound, 
-    T upper_bound,
-    Impl implementation
+// Differential fuzzer for every Impl and thread count.
+//
+// Small products are compared element-wise against Impl::NAIVE. Above
+// EXACT_LIMIT the O(N^3) reference is replaced by Freivalds' check: for random
+// r, A(Br) == Cr costs O(N^2) and a wrong C survives a round with probability
+// at most 1/R_RANGE. Operands are small integers, so every product is exact in
+// both int32 and float and the check runs in int64 without a tolerance.
+
+static constexpr std::size_t EXACT_LIMIT = 256;
+static constexpr std::size_t SCALAR_LIMIT = 1028;  // NAIVE/TRANSPOSED take minutes past this
+static constexpr int FREIVALDS_ROUNDS = 4;
+static constexpr std::int64_t R_RANGE = 1 << 16;
+
+static constexpr auto METHODS = std::to_array<std::pair<Impl, std::string_view>>({
+    {Impl::NAIVE,           "Naive"},
+    {Impl::TRANSPOSED,      "Transposed"},
+    {Impl::TRANSPOSED_SIMD, "Transposed SIMD"},
+    {Impl::TILED,           "Tiled"},
+    {Impl::TILED_SIMD,      "Tiled SIMD"},
+    {Impl::TILED_PREFETCH,  "Tiled PREFETCH"},
+    {Impl::TILED_REGISTERS, "Tiled REGISTERS"},
+    {Impl::AUTO,            "Auto"},
+});
+
+struct Case {
+    std::string_view method;
+    std::string_view type;
+    std::size_t m, n, k;
+    std::size_t threads;
+};
+
+struct Tally {
+    std::size_t passed{};
+    std::size_t failed{};
+
+    void record(bool ok, const Case& c) {
+        if (ok) {
+            ++passed;
+            return;
+        }
+        ++failed;
+        std::println("FAIL {:16} {:5} {}x{}x{} threads={}",
+            c.method, c.type, c.m, c.n, c.k, c.threads
+        );
+    }
+};
+
+template<typename T>
+constexpr std::string_view type_name() {
+    if constexpr (std::is_same_v<T, float>) return "float";
+    else if constexpr (std::is_same_v<T, double>) return "double";
+    else return "int";
+}
+
+std::vector<std::size_t> thread_counts() {
+    const std::size_t hw = std::max(std::thread::hardware_concurrency(), 1u);
+    std::vector<std::size_t> counts{1, 2, 3, hw};
+    std::ranges::sort(counts);
+    const auto [first, last] = std::ranges::unique(counts);
+    counts.erase(first, last);
+    return counts;
+}
+
+// a(x, y), b(x, y), c(x, y) read column x of row y, like SquareMatrix::get.
+bool freivalds(
+    std::size_t m, std::size_t n, std::size_t k,
+    auto&& a, auto&& b, auto&& c,
+    std::mt19937_64& rng
 ) {
-    auto a = SquareMatrix<T, N>::make_random(lower_bound, upper_bound);
-    auto b = SquareMatrix<T, N>::make_random(lower_bound, upper_bound);
-    
-    SquareMatrix<T, N> out1{}; a.multiply(b, out1, Impl::NAIVE);
-    SquareMatrix<T, N> out2{}; a.multiply(b, out2, implementation);
+    std::uniform_int_distribution<std::int64_t> distrib(0, R_RANGE - 1);
+    std::vector<std::int64_t> r(n), br(k);
+
+    for (int round{}; round < FREIVALDS_ROUNDS; ++round) {
+        for (auto& v: r)
+            v = distrib(rng);
 
-    return out1 == out2;
+        for (std::size_t y{}; y < k; ++y) {
+            std::int64_t sum{};
+            for (std::size_t x{}; x < n; ++x)
+                sum += static_cast<std::int64_t>(b(x, y)) * r[x];
+            br[y] = sum;
+        }
+
+        for (std::size_t y{}; y < m; ++y) {
+            std::int64_t abr{}, cr{};
+            for (std::size_t x{}; x < k; ++x)
+                abr += static_cast<std::int64_t>(a(x, y)) * br[x];
+            for (std::size_t x{}; x < n; ++x)
+                cr += static_cast<std::int64_t>(c(x, y)) * r[x];
+            if (abr != cr)
+                return false;
+        }
+    }
+    return true;
 }
 
-template<typename T, std::size_t START_SIZE, std::size_t END_SIZE>
-std::size_t validate_range_of_matrices(
-    T lower_bound, 
-    T upper_bound,
-    Impl implementation
+// =================================================================
+// SECTION: SquareMatrix (compile-time sizes around the 48-padding)
+// =================================================================
+
+// TILED_REGISTERS on a tiled layout; `reference` is only read when N is
+// small enough for an exact check.
+template<typename Layout, typename T, std::size_t N>
+void fuzz_tiled_layout(
+    const SquareMatrix<T, N>& a,
+    const SquareMatrix<T, N>& b,
+    const SquareMatrix<T, N>& reference,
+    std::string_view name,
+    std::mt19937_64& rng,
+    Tally& tally
 ) {
-    std::size_t correct_count = static_cast<std::size_t>(
-        validate_matrix_multiplication<T, START_SIZE>(lower_bound, upper_bound, implementation)
-    );
+    const auto tiled_a = a.template to<Layout>();
+    const auto tiled_b = b.template to<Layout>();
 
-    if constexpr (START_SIZE < END_SIZE)
-        correct_count += validate_range_of_matrices<T, START_SIZE + 4, END_SIZE>(
-            lower_bound, upper_bound, implementation
-        );
+    for (std::size_t threads: thread_counts()) {
+        SquareMatrix<T, N, Layout> out{};
+        tiled_a.multiply(tiled_b, out, Impl::TILED_REGISTERS, threads);
+
+        const bool ok = N <= EXACT_LIMIT
+            ? out.template to<layout::RowMajor>() == reference
+            : freivalds(N, N, N,
+                [&](auto x, auto y) { return a.get(x, y); },
+                [&](auto x, auto y) { return b.get(x, y); },
+                [&](auto x, auto y) { return out.get(x, y); },
+                rng
+            );
+        tally.record(ok, {name, type_name<T>(), N, N, N, threads});
+    }
+}
+
+template<typename T, std::size_t N>
+void fuzz_square(T lower_bound, T upper_bound, std::mt19937_64& rng, Tally& tally) {
+    const auto a = SquareMatrix<T, N>::make_random(lower_bound, upper_bound);
+    const auto b = SquareMatrix<T, N>::make_random(lower_bound, upper_bound);
 
-    return correct_count;
+    const bool exact = N <= EXACT_LIMIT;
+    SquareMatrix<T, N> reference{};
+    if (exact)
+        a.multiply(b, reference, Impl::NAIVE);
+
+    for (const auto& [implementation, name]: METHODS) {
+        const bool scalar = implementation == Impl::NAIVE || implementation == Impl::TRANSPOSED;
+        if (scalar && N > SCALAR_LIMIT)
+            continue;
+
+        for (std::size_t threads: thread_counts()) {
+            if (implementation != Impl::TILED_REGISTERS && implementation != Impl::AUTO && threads > 1)
+                break;
+
+            SquareMatrix<T, N> out{};
+            a.multiply(b, out, implementation, threads);
+
+            const bool ok = exact
+                ? out == reference
+                : freivalds(N, N, N,
+                    [&](auto x, auto y) { return a.get(x, y); },
+                    [&](auto x, auto y) { return b.get(x, y); },
+                    [&](auto x, auto y) { return out.get(x, y); },
+                    rng
+                );
+            tally.record(ok, {name, type_name<T>(), N, N, N, threads});
+        }
+    }
+
+    fuzz_tiled_layout<layout::BlockMajor>(a, b, reference, "REGISTERS Block", rng, tally);
+    fuzz_tiled_layout<layout::Morton>(a, b, reference, "REGISTERS Morton", rng, tally);
+}
+
+template<typename T, std::size_t... SIZES>
+void fuzz_square_sizes(T lower_bound, T upper_bound, std::mt19937_64& rng, Tally& tally) {
+    (fuzz_square<T, SIZES>(lower_bound, upper_bound, rng, tally), ...);
 }
 
+// Multiples of 48 and their +-4 neighbours, plus the power-of-two sizes the
+// benchmarks use, up to 4096+.
 template<typename T>
-std::size_t validate_implementation(
-    std::size_t  num_runs,
-    T lower_bound, 
-    T upper_bound,
-    Impl implementation
-) {
-    std::size_t correct_count = 0;
-    
-    for (std::size_t i = 0; i < num_runs; ++i) {
-        correct_count += (
-            validate_range_of_matrices<T, 4,   32> (lower_bound, upper_bound, implementation) +
-            validate_range_of_matrices<T, 36,  128>(lower_bound, upper_bound, implementation) +
-            validate_range_of_matrices<T, 132, 256>(lower_bound, upper_bound, implementation)
+void fuzz_adversarial_squares(T lower_bound, T upper_bound, std::mt19937_64& rng, Tally& tally) {
+    fuzz_square_sizes<T,
+        4, 8, 44, 48, 52, 92, 96, 100, 140, 144, 148, 188, 192, 196,
+        252, 256, 260, 476, 480, 484, 508, 512, 516,
+        1020, 1024, 1028, 2044, 2048, 2052, 4092, 4096, 4100
+    >(lower_bound, upper_bound, rng, tally);
+}
+
+// =================================================================
+// SECTION: Matrix (random runtime shapes)
+// =================================================================
+
+// Half the extents land within 3 of a multiple of 48, the rest anywhere.
+std::size_t random_extent(std::mt19937_64& rng, std::size_t limit) {
+    std::uniform_int_distribution<std::size_t> any(1, limit);
+    if (std::bernoulli_distribution(0.5)(rng))
+        return any(rng);
+
+    std::uniform_int_distribution<std::size_t> tile(1, std::max<std::size_t>(limit / 48, 1));
+    std::uniform_int_distribution<int> offset(-3, 3);
+    return std::clamp<std::size_t>(tile(rng) * 48 + offset(rng), 1, limit);
+}
+
+template<typename T>
+void fuzz_random_shape(std::size_t limit, T lower_bound, T upper_bound, std::mt19937_64& rng, Tally& tally) {
+    const std::size_t m = random_extent(rng, limit);
+    const std::size_t n = random_extent(rng, limit);
+    const std::size_t k = random_extent(rng, limit);
+
+    const auto a = Matrix<T>::make_random(m, k, lower_bound, upper_bound);
+    const auto b = Matrix<T>::make_random(k, n, lower_bound, upper_bound);
+
+    const bool exact = m * n * k <= EXACT_LIMIT * EXACT_LIMIT * EXACT_LIMIT;
+    Matrix<T> reference(m, n);
+    if (exact)
+        a.multiply(b, reference, Impl::NAIVE);
+
+    const auto counts = thread_counts();
+    const std::size_t threads = counts[std::uniform_int_distribution<std::size_t>(0, counts.size() - 1)(rng)];
+
+    const bool automatic = std::bernoulli_distribution(0.5)(rng);
+    Matrix<T> out(m, n);
+    a.multiply(b, out, automatic ? Impl::AUTO : Impl::TILED_REGISTERS, threads);
+
+    const bool ok = exact
+        ? out == reference
+        : freivalds(m, n, k,
+            [&](auto x, auto y) { return a.get(x, y); },
+            [&](auto x, auto y) { return b.get(x, y); },
+            [&](auto x, auto y) { return out.get(x, y); },
+            rng
         );
-    }
+    tally.record(ok, {automatic ? "Matrix AUTO" : "Matrix REGISTERS", type_name<T>(), m, n, k, threads});
+}
+
+template<typename T>
+void fuzz_type(std::size_t num_runs, T lower_bound, T upper_bound, std::mt19937_64& rng, Tally& tally) {
+    for (std::size_t run{}; run < num_runs; ++run) {
+        fuzz_adversarial_squares<T>(lower_bound, upper_bound, rng, tally);
 
-    return correct_count;
+        for (int i{}; i < 32; ++i)
+            fuzz_random_shape<T>(400, lower_bound, upper_bound, rng, tally);
+        for (int i{}; i < 4; ++i)
+            fuzz_random_shape<T>(3000, lower_bound, upper_bound, rng, tally);
+    }
 }
 
 int main(int argsc, char** argsv) {
     if (argsc <= 3) {
-        std::println("Specify [num runs] [rand lower bound] [rand upper bound]");
+        std::println("Specify [num runs] [rand lower bound] [rand upper bound] [seed]");
         return 0;
     }
-    
+
     const std::size_t  num_runs    = std::stol(argsv[1]);
     const std::int32_t lower_bound = std::stoi(argsv[2]);
     const std::int32_t upper_bound = std::stoi(argsv[3]);
+    const std::uint64_t seed       = argsc > 4 ? std::stoull(argsv[4]) : std::random_device{}();
 
-    assert(lower_bound < upper_bound && "Invalid bound. Lower bound < upper bound");
+    // Keeps every product exact in float (< 2^24) for sizes up to ~4100.
+    if (lower_bound >= upper_bound || std::max(std::abs(lower_bound), std::abs(upper_bound)) > 60) {
+        std::println("Invalid bounds. Need lower < upper and |bound| <= 60");
+        return 1;
+    }
 
-    const std::size_t ideal_correctness = (256 / 4) * num_runs;
+    std::println("seed {}", seed);
+    std::mt19937_64 rng(seed);
 
-    auto methods = std::to_array<std::pair<Impl, std::string_view>>({
-        {Impl::TRANSPOSED, "Transposed"},
-        {Impl::TILING, "Tiling"}
-    });
+    const auto start = std::chrono::steady_clock::now();
 
-    for (const auto& [implementation, name]: methods) {
-        auto correct_count = validate_implementation(num_runs, lower_bound, upper_bound, implementation);
-        double score = static_cast<double>(correct_count) 
-                     / static_cast<double>(ideal_correctness) 
-                     * 100.0;
-        std::println("{} : {}/{} [{:.2f}%]", name, correct_count, ideal_correctness, score);
-     }
+    Tally tally;
+    fuzz_type<std::int32_t>(num_runs, lower_bound, upper_bound, rng, tally);
+    fuzz_type<float>(num_runs, lower_bound, upper_bound, rng, tally);
 
-    return 0;
+    const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    const std::size_t total = tally.passed + tally.failed;
+    std::println("{}/{} passed [{:.2f}%] in {:.1f}s",
+        tally.passed, total, 100.0 * tally.passed / total, elapsed.count()
+    );
 
+    return tally.failed == 0 ? 0 : 1;
 }
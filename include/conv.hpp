@@ -0,0 +1,250 @@
+#pragma once
+
+// 2D convolution as an implicit GEMM on the register-blocked engine.
+//
+// Output pixels (n, oh, ow) are the rows of the product, output channels its
+// columns and the receptive field (ci, kh, kw) its depth. The im2col matrix
+// is never built: for every 48 x 48 tile of it the patch elements are
+// gathered straight from the input tensor into the A pack. The weights are
+// reshaped once, when the Conv2d is built, into contiguous 48 x 48 tiles the
+// microkernel reads in place, and each 48-pixel row tile of the result is
+// scattered into the output in the caller's format.
+
+#include "aligned_allocator.hpp"
+#include "kernels.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <span>
+#include <vector>
+
+namespace conv {
+
+enum class Format {
+    NCHW,  // batch, channel, row, column
+    NHWC,  // batch, row, column, channel
+};
+
+struct Shape {
+    std::size_t batch;
+    std::size_t in_channels;
+    std::size_t height;
+    std::size_t width;
+    std::size_t out_channels;
+    std::size_t kernel_h;
+    std::size_t kernel_w;
+    std::size_t stride_h = 1;
+    std::size_t stride_w = 1;
+    std::size_t pad_h = 0;
+    std::size_t pad_w = 0;
+    std::size_t dilation_h = 1;
+    std::size_t dilation_w = 1;
+
+    std::size_t out_height() const {
+        return (height + 2 * pad_h - dilation_h * (kernel_h - 1) - 1) / stride_h + 1;
+    }
+
+    std::size_t out_width() const {
+        return (width + 2 * pad_w - dilation_w * (kernel_w - 1) - 1) / stride_w + 1;
+    }
+
+    std::size_t input_size() const { return batch * in_channels * height * width; }
+    std::size_t weight_size() const { return out_channels * in_channels * kernel_h * kernel_w; }
+    std::size_t output_size() const { return batch * out_channels * out_height() * out_width(); }
+
+    // GEMM extents: rows = output pixels, depth = receptive field.
+    std::size_t pixels() const { return batch * out_height() * out_width(); }
+    std::size_t depth() const { return in_channels * kernel_h * kernel_w; }
+};
+
+// Weights are OIHW in both formats. Input and output share the format.
+template<typename T>
+class Conv2d {
+private:
+    static constexpr std::size_t TILE_SIZE = kernels::REGISTER_TILE;
+    using aligned_vector = std::vector<T, aligned_allocator<T, 64>>;
+
+    Shape shape_;
+    Format format_;
+    std::size_t col_tiles_;
+    std::size_t depth_tiles_;
+
+    // Element strides of the input tensor.
+    std::ptrdiff_t batch_stride_;
+    std::ptrdiff_t channel_stride_;
+    std::ptrdiff_t row_stride_;
+    std::ptrdiff_t col_stride_;
+
+    aligned_vector weight_tiles_;  // tile (k, j) at (k * col_tiles_ + j) * 48^2
+
+    // The depth index runs over the receptive field with the input's
+    // innermost dimension last: (ci, kh, kw) for NCHW, (kh, kw, ci) for NHWC.
+    struct Tap {
+        std::size_t channel;
+        std::size_t kh;
+        std::size_t kw;
+    };
+
+    Tap tap(std::size_t k) const {
+        const Shape& s = shape_;
+        if (format_ == Format::NCHW)
+            return {k / (s.kernel_h * s.kernel_w), k / s.kernel_w % s.kernel_h, k % s.kernel_w};
+        return {k % s.in_channels, k / s.in_channels / s.kernel_w, k / s.in_channels % s.kernel_w};
+    }
+
+    const T* weight_tile(std::size_t k, std::size_t j) const {
+        return weight_tiles_.data() + (k * col_tiles_ + j) * TILE_SIZE * TILE_SIZE;
+    }
+
+    // pack[r][c] = im2col[pixel + r][k + c], zero outside the input and
+    // outside the GEMM extents.
+    void gather(const T* input, std::size_t pixel, std::size_t k, kernels::Pack<T, TILE_SIZE>& pack) const {
+        GEMM_TRACE_SPAN(PACK);
+        const Shape& s = shape_;
+        const std::size_t out_h = s.out_height();
+        const std::size_t out_w = s.out_width();
+        const std::size_t row_limit = std::min(TILE_SIZE, s.pixels() - pixel);
+        const std::size_t col_limit = std::min(TILE_SIZE, s.depth() - k);
+
+        std::ptrdiff_t offset[TILE_SIZE], dy[TILE_SIZE], dx[TILE_SIZE];
+        for (std::size_t c{}; c < col_limit; ++c) {
+            const Tap t = tap(k + c);
+            dy[c] = static_cast<std::ptrdiff_t>(t.kh * s.dilation_h);
+            dx[c] = static_cast<std::ptrdiff_t>(t.kw * s.dilation_w);
+            offset[c] = static_cast<std::ptrdiff_t>(t.channel) * channel_stride_ + dy[c] * row_stride_ + dx[c] * col_stride_;
+        }
+
+        const auto height = static_cast<std::ptrdiff_t>(s.height);
+        const auto width = static_cast<std::ptrdiff_t>(s.width);
+        const auto reach_h = static_cast<std::ptrdiff_t>((s.kernel_h - 1) * s.dilation_h);
+        const auto reach_w = static_cast<std::ptrdiff_t>((s.kernel_w - 1) * s.dilation_w);
+
+        for (std::size_t r{}; r < row_limit; ++r) {
+            const std::size_t p = pixel + r;
+            const std::size_t n = p / (out_h * out_w);
+            const auto y0 = static_cast<std::ptrdiff_t>(p / out_w % out_h * s.stride_h) - static_cast<std::ptrdiff_t>(s.pad_h);
+            const auto x0 = static_cast<std::ptrdiff_t>(p % out_w * s.stride_w) - static_cast<std::ptrdiff_t>(s.pad_w);
+            const std::ptrdiff_t origin = static_cast<std::ptrdiff_t>(n) * batch_stride_ + y0 * row_stride_ + x0 * col_stride_;
+            T* dst = pack.data() + r * TILE_SIZE;
+
+            if (y0 >= 0 && x0 >= 0 && y0 + reach_h < height && x0 + reach_w < width) {
+                for (std::size_t c{}; c < col_limit; ++c)
+                    dst[c] = input[origin + offset[c]];
+            } else {
+                for (std::size_t c{}; c < col_limit; ++c) {
+                    const std::ptrdiff_t y = y0 + dy[c], x = x0 + dx[c];
+                    dst[c] = y >= 0 && y < height && x >= 0 && x < width ? input[origin + offset[c]] : T{};
+                }
+            }
+            std::fill(dst + col_limit, dst + TILE_SIZE, T{});
+        }
+        std::fill(pack.data() + row_limit * TILE_SIZE, pack.data() + pack.size(), T{});
+    }
+
+    // Writes rows [pixel, pixel + 48) of the result tile into the output.
+    void scatter(const T* c_tile, std::size_t pixel, T* output) const {
+        const Shape& s = shape_;
+        const std::size_t row_limit = std::min(TILE_SIZE, s.pixels() - pixel);
+        const std::size_t stride = col_tiles_ * TILE_SIZE;
+
+        if (format_ == Format::NHWC) {
+            for (std::size_t r{}; r < row_limit; ++r)
+                std::copy_n(c_tile + r * stride, s.out_channels, output + (pixel + r) * s.out_channels);
+            return;
+        }
+
+        const std::size_t plane = s.out_height() * s.out_width();
+        for (std::size_t r{}; r < row_limit; ++r) {
+            const std::size_t p = pixel + r;
+            T* dst = output + p / plane * s.out_channels * plane + p % plane;
+            for (std::size_t co{}; co < s.out_channels; ++co)
+                dst[co * plane] = c_tile[r * stride + co];
+        }
+    }
+
+public:
+    Conv2d(const Shape& shape, Format format, std::span<const T> weights)
+        : shape_(shape)
+        , format_(format)
+        , col_tiles_(kernels::padded(shape.out_channels) / TILE_SIZE)
+        , depth_tiles_(kernels::padded(shape.depth()) / TILE_SIZE)
+        , weight_tiles_(depth_tiles_ * col_tiles_ * TILE_SIZE * TILE_SIZE) {
+        assert(weights.size() == shape.weight_size() && "weights must be OIHW");
+        assert(shape.height + 2 * shape.pad_h > shape.dilation_h * (shape.kernel_h - 1) && "kernel taller than the input");
+        assert(shape.width + 2 * shape.pad_w > shape.dilation_w * (shape.kernel_w - 1) && "kernel wider than the input");
+
+        if (format == Format::NCHW) {
+            col_stride_ = 1;
+            row_stride_ = static_cast<std::ptrdiff_t>(shape.width);
+            channel_stride_ = row_stride_ * static_cast<std::ptrdiff_t>(shape.height);
+            batch_stride_ = channel_stride_ * static_cast<std::ptrdiff_t>(shape.in_channels);
+        } else {
+            channel_stride_ = 1;
+            col_stride_ = static_cast<std::ptrdiff_t>(shape.in_channels);
+            row_stride_ = col_stride_ * static_cast<std::ptrdiff_t>(shape.width);
+            batch_stride_ = row_stride_ * static_cast<std::ptrdiff_t>(shape.height);
+        }
+
+        // B[k][co] = W[co][tap(k)], stored tile by tile.
+        for (std::size_t k{}; k < shape.depth(); ++k) {
+            const Tap t = tap(k);
+            T* row = weight_tiles_.data() + (k / TILE_SIZE * col_tiles_) * TILE_SIZE * TILE_SIZE + k % TILE_SIZE * TILE_SIZE;
+            for (std::size_t co{}; co < shape.out_channels; ++co) {
+                const std::size_t src = ((co * shape.in_channels + t.channel) * shape.kernel_h + t.kh) * shape.kernel_w + t.kw;
+                row[co / TILE_SIZE * TILE_SIZE * TILE_SIZE + co % TILE_SIZE] = weights[src];
+            }
+        }
+    }
+
+    const Shape& shape() const { return shape_; }
+    Format format() const { return format_; }
+
+    // output = conv(input); both tensors are dense in the configured format.
+    // Pixel tiles are spread over `threads` workers.
+    void run(std::span<const T> input, std::span<T> output, std::size_t threads = 1) const {
+        GEMM_TRACE_SPAN(MULTIPLY);
+        assert(input.size() == shape_.input_size() && "input has the wrong size");
+        assert(output.size() == shape_.output_size() && "output has the wrong size");
+
+        const std::size_t stride = col_tiles_ * TILE_SIZE;
+        const std::size_t row_tiles = kernels::padded(shape_.pixels()) / TILE_SIZE;
+
+        kernels::for_each_row_tile(row_tiles, threads, [&](std::size_t tile) {
+            GEMM_TRACE_SPAN(TILE_ROW);
+            thread_local aligned_vector c_tile;
+            c_tile.assign(TILE_SIZE * stride, T{});
+
+            alignas(64) kernels::Pack<T, TILE_SIZE> a_pack;
+            const std::size_t pixel = tile * TILE_SIZE;
+
+            const std::size_t rows = std::min(TILE_SIZE, shape_.pixels() - pixel);
+
+            for (std::size_t k{}; k < depth_tiles_; ++k) {
+                GEMM_TRACE_SPAN(TILE_PANEL);
+                gather(input.data(), pixel, k * TILE_SIZE, a_pack);
+                const std::size_t depth = std::min(TILE_SIZE, shape_.depth() - k * TILE_SIZE);
+                for (std::size_t j{}; j < col_tiles_; ++j) {
+                    const std::size_t cols = std::min(TILE_SIZE, shape_.out_channels - j * TILE_SIZE);
+                    kernels::multiply_tile<T, TILE_SIZE>(a_pack.data(), weight_tile(k, j), c_tile.data(), stride, 0, j * TILE_SIZE, rows, cols, depth);
+                }
+            }
+            scatter(c_tile.data(), pixel, output.data());
+        });
+    }
+};
+
+// One-shot convolution; build a Conv2d to reuse the reshaped weights.
+template<typename T>
+void conv2d(
+    const Shape& shape,
+    Format format,
+    std::span<const T> input,
+    std::span<const T> weights,
+    std::span<T> output,
+    std::size_t threads = 1
+) {
+    Conv2d<T>(shape, format, weights).run(input, output, threads);
+}
+
+} // namespace conv
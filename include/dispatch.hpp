@@ -0,0 +1,231 @@
+#pragma once
+
+// Kernel and thread-count selection behind Impl::AUTO.
+//
+// decide() is a fixed table distilled from gemm_sweep runs: scalar code
+// wins only for tiny products, the 32-wide TILED_SIMD wins when padding to
+// the 48-element register tile would inflate the work by more than a
+// fifth, and TILED_REGISTERS wins everywhere else and is the only kernel
+// that uses more than one thread. With refinement switched on, the first
+// calls for each new shape time every plausible candidate, and later calls
+// use the fastest one measured.
+
+#include "impl.hpp"
+#include "kernels.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <map>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <tuple>
+#include <vector>
+
+namespace dispatch {
+
+enum class Engine : char {
+    SQUARE,        // SquareMatrix, row-major: every Impl
+    SQUARE_TILED,  // SquareMatrix, tiled layout: NAIVE and TILED_REGISTERS
+    RUNTIME,       // Matrix: NAIVE and TILED_REGISTERS
+};
+
+struct Problem {
+    Engine engine;
+    std::size_t m;
+    std::size_t n;
+    std::size_t k;
+    const void* type;  // &type_tag<T>, distinguishes element types
+
+    auto key() const { return std::tuple(engine, m, n, k, type); }
+};
+
+template<typename T>
+inline constexpr char type_tag{};
+
+template<typename T>
+Problem problem(Engine engine, std::size_t m, std::size_t n, std::size_t k) {
+    return {engine, m, n, k, &type_tag<T>};
+}
+
+struct Choice {
+    Impl impl;
+    std::size_t threads;
+
+    bool operator==(const Choice&) const = default;
+};
+
+inline constexpr std::size_t TINY_PRODUCT = 16 * 16 * 16;        // multiply-adds
+inline constexpr std::size_t PARALLEL_PRODUCT = 192 * 192 * 192;
+inline constexpr double PADDING_TOLERANCE = 1.2;
+
+inline std::size_t hardware_threads() {
+    return std::max<std::size_t>(std::thread::hardware_concurrency(), 1);
+}
+
+// Worker count for TILED_REGISTERS: one per 48-row tile at most, and only
+// once the product is big enough to pay for starting threads.
+inline std::size_t threads_for(const Problem& p, std::size_t limit) {
+    if (p.m * p.n * p.k < PARALLEL_PRODUCT)
+        return 1;
+    return std::clamp<std::size_t>(kernels::padded(p.m) / kernels::REGISTER_TILE, 1, limit);
+}
+
+// `limit` caps the thread count (the caller's `threads`, or every hardware
+// thread when that is 0).
+inline Choice decide(const Problem& p, std::size_t limit) {
+    const std::size_t product = p.m * p.n * p.k;
+    if (product <= TINY_PRODUCT)
+        return {Impl::NAIVE, 1};
+
+    const std::size_t threads = threads_for(p, limit);
+    if (p.engine != Engine::SQUARE || threads > 1)
+        return {Impl::TILED_REGISTERS, threads};
+
+    const double padded = static_cast<double>(kernels::padded(p.m)) * kernels::padded(p.n) * kernels::padded(p.k);
+    if (padded > PADDING_TOLERANCE * static_cast<double>(product))
+        return {Impl::TILED_SIMD, 1};
+    return {Impl::TILED_REGISTERS, 1};
+}
+
+// What refinement times: the table's pick plus the alternatives that can
+// plausibly beat it. Scalar kernels are left out once they are hopeless.
+inline std::vector<Choice> candidates(const Problem& p, std::size_t limit) {
+    std::vector<Choice> result{decide(p, limit)};
+    auto add = [&](Choice choice) {
+        if (std::ranges::find(result, choice) == result.end())
+            result.push_back(choice);
+    };
+
+    if (p.m * p.n * p.k <= 64 * TINY_PRODUCT)
+        add({Impl::NAIVE, 1});
+    if (p.engine == Engine::SQUARE) {
+        add({Impl::TRANSPOSED_SIMD, 1});
+        add({Impl::TILED_SIMD, 1});
+    }
+    add({Impl::TILED_REGISTERS, 1});
+    if (const std::size_t threads = std::clamp<std::size_t>(kernels::padded(p.m) / kernels::REGISTER_TILE, 1, limit); threads > 1)
+        add({Impl::TILED_REGISTERS, threads});
+    return result;
+}
+
+// Online refinement. choose() hands out each candidate SAMPLES times for a
+// new problem, flagged as a trial; record() keeps the best time per
+// candidate, and once all are in, the fastest is returned for good.
+// Entries are kept per thread limit, so a winner settled under a high
+// limit is never handed to a caller that asked for fewer threads.
+class Tuner {
+private:
+    static constexpr std::size_t SAMPLES = 2;
+
+    using Key = decltype(std::tuple_cat(std::declval<Problem>().key(), std::tuple<std::size_t>{}));
+
+    static Key key(const Problem& p, std::size_t limit) {
+        return std::tuple_cat(p.key(), std::tuple(limit));
+    }
+
+    struct Entry {
+        std::vector<Choice> candidates;
+        std::vector<double> best_seconds;
+        std::size_t issued{};
+        std::size_t recorded{};
+        Choice winner{};
+        bool settled = false;
+    };
+
+    std::mutex mutex_;
+    std::map<Key, Entry> entries_;
+    bool enabled_ = false;
+
+public:
+    struct Pick {
+        Choice choice;
+        bool trial;  // time the call and report it through record()
+    };
+
+    void set_enabled(bool enabled) {
+        std::lock_guard lock(mutex_);
+        enabled_ = enabled;
+    }
+
+    void clear() {
+        std::lock_guard lock(mutex_);
+        entries_.clear();
+    }
+
+    Pick choose(const Problem& p, std::size_t limit) {
+        std::lock_guard lock(mutex_);
+        if (!enabled_)
+            return {decide(p, limit), false};
+
+        auto [it, inserted] = entries_.try_emplace(key(p, limit));
+        Entry& entry = it->second;
+        if (inserted) {
+            entry.candidates = candidates(p, limit);
+            entry.best_seconds.assign(entry.candidates.size(), 0.0);
+        }
+        if (entry.settled)
+            return {entry.winner, false};
+        if (entry.issued == entry.candidates.size() * SAMPLES)
+            return {entry.candidates.front(), false};  // trials still running elsewhere
+        return {entry.candidates[entry.issued++ % entry.candidates.size()], true};
+    }
+
+    void record(const Problem& p, std::size_t limit, Choice choice, double seconds) {
+        std::lock_guard lock(mutex_);
+        const auto it = entries_.find(key(p, limit));
+        if (it == entries_.end() || it->second.settled)
+            return;
+
+        Entry& entry = it->second;
+        const auto index = std::ranges::find(entry.candidates, choice) - entry.candidates.begin();
+        double& best = entry.best_seconds[index];
+        best = best == 0.0 ? seconds : std::min(best, seconds);
+
+        if (++entry.recorded == entry.candidates.size() * SAMPLES) {
+            const auto fastest = std::ranges::min_element(entry.best_seconds) - entry.best_seconds.begin();
+            entry.winner = entry.candidates[fastest];
+            entry.settled = true;
+        }
+    }
+
+    // The settled choice for a problem under a thread limit, if refinement
+    // has finished with it.
+    std::optional<Choice> settled(const Problem& p, std::size_t limit) {
+        std::lock_guard lock(mutex_);
+        const auto it = entries_.find(key(p, limit));
+        if (it == entries_.end() || !it->second.settled)
+            return std::nullopt;
+        return it->second.winner;
+    }
+};
+
+inline Tuner& tuner() {
+    static Tuner instance;
+    return instance;
+}
+
+// Off by default: which kernel runs changes the floating-point summation
+// order, so refined results can differ between runs in the last bits.
+inline void set_refinement(bool enabled) {
+    tuner().set_enabled(enabled);
+}
+
+// Runs fn(choice) with the choice for `p`, timing it when it is a trial.
+template<typename Fn>
+void run(const Problem& p, std::size_t threads, Fn&& fn) {
+    const std::size_t limit = threads == 0 ? hardware_threads() : threads;
+    const auto [choice, trial] = tuner().choose(p, limit);
+    if (!trial) {
+        fn(choice);
+        return;
+    }
+
+    const auto start = std::chrono::steady_clock::now();
+    fn(choice);
+    const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    tuner().record(p, limit, choice, elapsed.count());
+}
+
+} // namespace dispatch
@@ -0,0 +1,112 @@
+#pragma once
+
+#include "kernels.hpp"
+#include "mat.hpp"
+#include "matrix.hpp"
+#include "work_stealing_pool.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <future>
+#include <thread>
+
+// Asynchronous multiplies on a shared work-stealing pool.
+//
+// submit() returns immediately; the future is ready once out = a * b. Products
+// below SMALL_PRODUCT_OPS run whole as a single tile. Larger ones are split
+// into 48-row x COLUMN_BLOCK tiles of C, each packing and computing its own
+// block, so one big job spreads over every worker while a small job queued
+// behind it only waits for the tile in flight. Operands must outlive the
+// future.
+class GemmScheduler {
+private:
+    static constexpr double SMALL_PRODUCT_OPS = 2.0 * 192 * 192 * 192;
+    static constexpr std::size_t COLUMN_BLOCK = 10 * kernels::REGISTER_TILE;
+
+    WorkStealingPool pool_;
+
+    template<typename T>
+    std::future<void> submit_padded(
+        const T* a_ptr, std::size_t a_stride,
+        const T* b_ptr, std::size_t b_stride,
+        T* c_ptr,       std::size_t c_stride,
+        std::size_t rows, std::size_t cols, std::size_t depth,
+        double ops,
+        Priority priority
+    ) {
+        auto run_block = [=](std::size_t row_begin, std::size_t row_end,
+                             std::size_t col_begin, std::size_t col_end) {
+            for (std::size_t row = row_begin; row < row_end; ++row)
+                std::fill(c_ptr + row * c_stride + col_begin, c_ptr + row * c_stride + col_end, T{});
+            kernels::multiply_block(
+                a_ptr, a_stride, b_ptr, b_stride, c_ptr, c_stride,
+                row_begin, row_end, col_begin, col_end, depth
+            );
+        };
+
+        if (ops < SMALL_PRODUCT_OPS) {
+            return pool_.submit(1, [=](std::size_t) { run_block(0, rows, 0, cols); }, priority);
+        }
+
+        const std::size_t row_tiles = rows / kernels::REGISTER_TILE;
+        const std::size_t col_blocks = (cols + COLUMN_BLOCK - 1) / COLUMN_BLOCK;
+
+        return pool_.submit(row_tiles * col_blocks, [=](std::size_t tile) {
+            const std::size_t row = (tile / col_blocks) * kernels::REGISTER_TILE;
+            const std::size_t col = (tile % col_blocks) * COLUMN_BLOCK;
+            run_block(row, row + kernels::REGISTER_TILE, col, std::min(col + COLUMN_BLOCK, cols));
+        }, priority);
+    }
+
+public:
+    explicit GemmScheduler(std::size_t workers = std::thread::hardware_concurrency())
+        : pool_(workers) {}
+
+    template<typename T>
+    std::future<void> submit(
+        const Matrix<T>& a,
+        const Matrix<T>& b,
+        Matrix<T>& out,
+        Priority priority = Priority::NORMAL
+    ) {
+        assert(a.cols() == b.rows() && "inner dimensions must agree");
+        assert(out.rows() == a.rows() && out.cols() == b.cols() && "output has the wrong shape");
+
+        return submit_padded(
+            a.data(),   a.stride(),
+            b.data(),   b.stride(),
+            out.data(), out.stride(),
+            a.padded_rows(), b.stride(), a.stride(),
+            2.0 * a.rows() * b.cols() * a.cols(),
+            priority
+        );
+    }
+
+    // The result's transposed copy is not refreshed, as with multiply().
+    template<typename T, std::size_t N>
+    std::future<void> submit(
+        const SquareMatrix<T, N>& a,
+        const SquareMatrix<T, N>& b,
+        SquareMatrix<T, N>& out,
+        Priority priority = Priority::NORMAL
+    ) {
+        constexpr std::size_t WIDTH = SquareMatrix<T, N>::stride();
+        return submit_padded(
+            a.data(),   WIDTH,
+            b.data(),   WIDTH,
+            out.data(), WIDTH,
+            WIDTH, WIDTH, WIDTH,
+            2.0 * N * N * N,
+            priority
+        );
+    }
+
+    WorkStealingPool::Metrics metrics() const {
+        return pool_.metrics();
+    }
+
+    std::size_t workers() const {
+        return pool_.size();
+    }
+};
@@ -0,0 +1,130 @@
+#pragma once
+
+// 16-bit storage types for the mixed-precision engine. Neither does
+// arithmetic: operands are widened to fp32 while packing, the register
+// kernel accumulates in fp32, and results are rounded back (to nearest,
+// ties to even) only when C itself is 16-bit.
+//
+// bf16 keeps fp32's exponent, so widening is a 16-bit shift. fp16 (IEEE
+// binary16) uses F16C's vcvtph2ps / vcvtps2ph when built with -mf16c and an
+// exact scalar conversion otherwise.
+
+#include <bit>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+#include <immintrin.h>
+
+struct bf16 {
+    std::uint16_t bits{};
+
+    bf16() = default;
+
+    explicit bf16(float value) {
+        const auto x = std::bit_cast<std::uint32_t>(value);
+        if ((x & 0x7FFFFFFFu) > 0x7F800000u)
+            bits = static_cast<std::uint16_t>(x >> 16 | 0x0040);  // quiet NaN
+        else
+            bits = static_cast<std::uint16_t>((x + 0x7FFFu + (x >> 16 & 1)) >> 16);
+    }
+
+    operator float() const {
+        return std::bit_cast<float>(static_cast<std::uint32_t>(bits) << 16);
+    }
+};
+
+struct fp16 {
+    std::uint16_t bits{};
+
+    fp16() = default;
+
+    explicit fp16(float value) {
+        const auto x = std::bit_cast<std::uint32_t>(value);
+        const auto sign = static_cast<std::uint16_t>(x >> 16 & 0x8000);
+        const std::uint32_t magnitude = x & 0x7FFFFFFFu;
+
+        if (magnitude > 0x7F800000u) {
+            bits = sign | 0x7E00;  // quiet NaN
+        } else if (magnitude >= 0x47800000u) {
+            bits = sign | 0x7C00;  // overflows to infinity
+        } else if (magnitude < 0x38800000u) {
+            // Subnormal or zero: adding 0.5f lines the mantissa up with the
+            // fp16 subnormal grid and lets the FPU do the rounding.
+            const float aligned = std::bit_cast<float>(magnitude) + 0.5f;
+            bits = sign | static_cast<std::uint16_t>(std::bit_cast<std::uint32_t>(aligned) - 0x3F000000u);
+        } else {
+            const std::uint32_t odd = magnitude >> 13 & 1;
+            bits = sign | static_cast<std::uint16_t>((magnitude + 0xC8000FFFu + odd) >> 13);
+        }
+    }
+
+    operator float() const {
+        const std::uint32_t sign = static_cast<std::uint32_t>(bits & 0x8000) << 16;
+        const std::uint32_t exponent = bits >> 10 & 0x1F;
+        const std::uint32_t mantissa = bits & 0x3FF;
+
+        if (exponent == 0) {
+            const float value = static_cast<float>(mantissa) * 0x1p-24f;
+            return std::bit_cast<float>(std::bit_cast<std::uint32_t>(value) | sign);
+        }
+        if (exponent == 0x1F)
+            return std::bit_cast<float>(sign | 0x7F800000u | mantissa << 13);
+        return std::bit_cast<float>(sign | (exponent + 112) << 23 | mantissa << 13);
+    }
+};
+
+template<typename T>
+concept half_float = std::same_as<T, bf16> || std::same_as<T, fp16>;
+
+// Type the products of T are summed in.
+template<typename T>
+using accumulator_t = std::conditional_t<half_float<T>, float, T>;
+
+// dst[i] = float(src[i]) for i < count
+inline void widen(const bf16* src, float* dst, std::size_t count) {
+    std::size_t i{};
+#if defined(__AVX2__)
+    for (; i + 8 <= count; i += 8) {
+        const __m128i half = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+        _mm256_storeu_ps(dst + i, _mm256_castsi256_ps(_mm256_slli_epi32(_mm256_cvtepu16_epi32(half), 16)));
+    }
+#elif defined(__SSE2__)
+    for (; i + 4 <= count; i += 4) {
+        const __m128i half = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(src + i));
+        _mm_storeu_ps(dst + i, _mm_castsi128_ps(_mm_unpacklo_epi16(_mm_setzero_si128(), half)));
+    }
+#endif
+    for (; i < count; ++i)
+        dst[i] = src[i];
+}
+
+inline void widen(const fp16* src, float* dst, std::size_t count) {
+    std::size_t i{};
+#if defined(__F16C__)
+    for (; i + 8 <= count; i += 8)
+        _mm256_storeu_ps(dst + i, _mm256_cvtph_ps(_mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i))));
+#endif
+    for (; i < count; ++i)
+        dst[i] = src[i];
+}
+
+// dst[i] = T(src[i]) for i < count, rounding to nearest even
+inline void narrow(const float* src, bf16* dst, std::size_t count) {
+    for (std::size_t i{}; i < count; ++i)
+        dst[i] = bf16(src[i]);
+}
+
+inline void narrow(const float* src, fp16* dst, std::size_t count) {
+    std::size_t i{};
+#if defined(__F16C__)
+    for (; i + 8 <= count; i += 8)
+        _mm_storeu_si128(
+            reinterpret_cast<__m128i*>(dst + i),
+            _mm256_cvtps_ph(_mm256_loadu_ps(src + i), _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC)
+        );
+#endif
+    for (; i < count; ++i)
+        dst[i] = fp16(src[i]);
+}
@@ -0,0 +1,17 @@
+#pragma once
+
+// Kernel selectors shared by SquareMatrix, Matrix and the dispatcher.
+
+enum class Impl: char { 
+    NAIVE, 
+    TRANSPOSED, TRANSPOSED_SIMD, 
+    TILED,      TILED_SIMD,      TILED_PREFETCH,    TILED_REGISTERS,
+    AUTO  // picked per shape and type by dispatch.hpp
+};
+
+// Which half of a symmetric result syrk() writes, or which half of the
+// operand trsm() reads (diagonal included).
+enum class Triangle: char { LOWER, UPPER };
+
+// Whether trsm() reads the diagonal or takes it to be all ones.
+enum class Diagonal: char { NON_UNIT, UNIT };
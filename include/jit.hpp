@@ -0,0 +1,316 @@
+#pragma once
+
+// Runtime-generated f32 microkernels (x86-64, AVX2 + FMA).
+//
+// microkernel_6x2 always computes a full 48 x 48 x 48 tile product, so the
+// ragged last tiles of a runtime-shaped Matrix spend most of their time
+// multiplying zero padding, and the ISA is fixed when the binary is built.
+// jit::kernel(shape) instead emits machine code for exactly one tile shape:
+// the register block (rows x vectors) is chosen to fit the tile and the
+// depth loop is fully unrolled to the exact K. Kernels are cached by shape
+// in executable pages for the life of the process, up to Cache::CAPACITY
+// shapes; later shapes fall back to the template kernels.
+//
+// Build with -DGEMM_JIT (the GEMM_ENABLE_JIT cmake option) to route the
+// register-blocked engine through here. kernel() returns nullptr when the
+// host lacks AVX2/FMA, when executable memory cannot be mapped, or after
+// set_enabled(false); callers then use the template kernels.
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <mutex>
+#include <shared_mutex>
+#include <unordered_map>
+#include <vector>
+
+#include <sys/mman.h>
+
+namespace jit {
+
+// Computes C += A * B for one tile: a is a row-major pack with a 48-float
+// row stride, b a 48-float-stride pack, c the tile origin in a matrix whose
+// rows are c_stride_bytes apart.
+using Kernel = void (*)(const float* a, const float* b, float* c, std::size_t c_stride_bytes);
+
+// Logical extent of one tile product, each in [1, 48].
+struct Shape {
+    std::size_t rows;
+    std::size_t cols;
+    std::size_t depth;
+
+    bool operator==(const Shape&) const = default;
+};
+
+// =================================================================
+// SECTION: ASSEMBLER
+// Just the encodings the kernel needs: VEX.256 moves, broadcasts, FMA and
+// a few 64-bit integer ops for the loops.
+// =================================================================
+
+enum Gpr : std::uint8_t { RAX, RCX, RDX, RBX, RSP, RBP, RSI, RDI, R8, R9, R10, R11 };
+
+class Assembler {
+private:
+    std::vector<std::uint8_t> code_;
+
+    void byte(std::uint32_t value) {
+        code_.push_back(static_cast<std::uint8_t>(value));
+    }
+
+    void dword(std::int32_t value) {
+        for (std::size_t i{}; i < 4; ++i)
+            byte(static_cast<std::uint32_t>(value) >> (i * 8));
+    }
+
+    // Three-byte VEX, L = 256. map: 1 = 0F, 2 = 0F38; pp: 0 = none, 1 = 66.
+    void vex(std::uint8_t reg, std::uint8_t vvvv, std::uint8_t rm, std::uint8_t map, std::uint8_t pp) {
+        byte(0xC4);
+        byte((reg < 8) << 7 | 1 << 6 | (rm < 8) << 5 | map);
+        byte((~vvvv & 0xF) << 3 | 1 << 2 | pp);
+    }
+
+    void rex_w(std::uint8_t reg, std::uint8_t rm) {
+        byte(0x48 | (reg >= 8) << 2 | (rm >= 8));
+    }
+
+    void modrm_reg(std::uint8_t reg, std::uint8_t rm) {
+        byte(0xC0 | (reg & 7) << 3 | (rm & 7));
+    }
+
+    void modrm_mem(std::uint8_t reg, Gpr base, std::int32_t disp) {
+        const std::uint8_t mod = disp == 0 && (base & 7) != RBP ? 0 : disp >= -128 && disp < 128 ? 1 : 2;
+        byte(mod << 6 | (reg & 7) << 3 | (base & 7));
+        if ((base & 7) == RSP)
+            byte(0x24);
+        if (mod == 1)
+            byte(static_cast<std::uint32_t>(disp));
+        else if (mod == 2)
+            dword(disp);
+    }
+
+public:
+    std::size_t position() const { return code_.size(); }
+    const std::vector<std::uint8_t>& code() const { return code_; }
+
+    void vmovups(std::uint8_t ymm, Gpr base, std::int32_t disp) {
+        vex(ymm, 0, base, 1, 0); byte(0x10); modrm_mem(ymm, base, disp);
+    }
+
+    void vmovups(Gpr base, std::int32_t disp, std::uint8_t ymm) {
+        vex(ymm, 0, base, 1, 0); byte(0x11); modrm_mem(ymm, base, disp);
+    }
+
+    void vbroadcastss(std::uint8_t ymm, Gpr base, std::int32_t disp) {
+        vex(ymm, 0, base, 2, 1); byte(0x18); modrm_mem(ymm, base, disp);
+    }
+
+    // dst += a * b
+    void vfmadd231ps(std::uint8_t dst, std::uint8_t a, std::uint8_t b) {
+        vex(dst, a, b, 2, 1); byte(0xB8); modrm_reg(dst, b);
+    }
+
+    void vzeroupper() { byte(0xC5); byte(0xF8); byte(0x77); }
+    void ret() { byte(0xC3); }
+
+    void mov(Gpr dst, Gpr src) { rex_w(src, dst); byte(0x89); modrm_reg(src, dst); }
+    void mov(Gpr dst, std::int32_t imm) { rex_w(0, dst); byte(0xC7); modrm_reg(0, dst); dword(imm); }
+    void add(Gpr dst, Gpr src) { rex_w(src, dst); byte(0x01); modrm_reg(src, dst); }
+    void add(Gpr dst, std::int32_t imm) { rex_w(0, dst); byte(0x81); modrm_reg(0, dst); dword(imm); }
+    void dec(Gpr dst) { rex_w(0, dst); byte(0xFF); modrm_reg(1, dst); }
+
+    // jnz to an earlier position()
+    void jnz(std::size_t target) {
+        byte(0x0F); byte(0x85);
+        dword(static_cast<std::int32_t>(target) - static_cast<std::int32_t>(position() + 4));
+    }
+};
+
+// =================================================================
+// SECTION: GENERATOR
+// =================================================================
+
+inline constexpr std::size_t TILE = 48;            // pack edge, in floats
+inline constexpr std::size_t VECTOR = 8;           // floats per ymm
+inline constexpr std::int32_t PACK_ROW = TILE * 4; // pack row stride, bytes
+
+// Register block for a tile: `vectors` ymm columns by `rows` rows, with
+// rows * vectors accumulators + vectors B registers + one A broadcast in the
+// 16 ymm registers. Rows divide 48 so rounding up stays inside the pack.
+struct Block {
+    std::size_t rows;
+    std::size_t vectors;
+};
+
+inline Block choose_block(const Shape& shape) {
+    const std::size_t vectors = (shape.cols + VECTOR - 1) / VECTOR == 1 ? 1 : 2;
+    const std::size_t max_rows = vectors == 1 ? 12 : 6;
+    const std::size_t wanted = std::min(shape.rows, max_rows);
+    for (std::size_t rows : {1, 2, 3, 4, 6, 8, 12})
+        if (rows >= wanted)
+            return {rows, vectors};
+    return {max_rows, vectors};
+}
+
+// rdi = a, rsi = b, rdx = c, rcx = c stride in bytes. Loops over register
+// blocks (r8 rows, r9 columns); r10 and r11 walk B and C across a row of
+// blocks, rax walks the rows of C inside one block.
+inline std::vector<std::uint8_t> generate(const Shape& shape) {
+    const Block block = choose_block(shape);
+    const std::size_t width = block.vectors * VECTOR;
+    const std::size_t row_blocks = (shape.rows + block.rows - 1) / block.rows;
+    const std::size_t col_blocks = (shape.cols + width - 1) / width;
+
+    const auto acc = [&](std::size_t r, std::size_t v) { return static_cast<std::uint8_t>(r * block.vectors + v); };
+    const auto b_reg = [&](std::size_t v) { return static_cast<std::uint8_t>(block.rows * block.vectors + v); };
+    const std::uint8_t a_reg = 15;
+
+    Assembler as;
+    as.mov(R8, static_cast<std::int32_t>(row_blocks));
+    const std::size_t row_loop = as.position();
+    as.mov(R9, static_cast<std::int32_t>(col_blocks));
+    as.mov(R10, RSI);
+    as.mov(R11, RDX);
+    const std::size_t col_loop = as.position();
+
+    as.mov(RAX, R11);
+    for (std::size_t r{}; r < block.rows; ++r) {
+        for (std::size_t v{}; v < block.vectors; ++v)
+            as.vmovups(acc(r, v), RAX, static_cast<std::int32_t>(v * 32));
+        as.add(RAX, RCX);
+    }
+
+    for (std::size_t k{}; k < shape.depth; ++k) {
+        for (std::size_t v{}; v < block.vectors; ++v)
+            as.vmovups(b_reg(v), R10, static_cast<std::int32_t>(k * PACK_ROW + v * 32));
+        for (std::size_t r{}; r < block.rows; ++r) {
+            as.vbroadcastss(a_reg, RDI, static_cast<std::int32_t>(r * PACK_ROW + k * 4));
+            for (std::size_t v{}; v < block.vectors; ++v)
+                as.vfmadd231ps(acc(r, v), a_reg, b_reg(v));
+        }
+    }
+
+    as.mov(RAX, R11);
+    for (std::size_t r{}; r < block.rows; ++r) {
+        for (std::size_t v{}; v < block.vectors; ++v)
+            as.vmovups(RAX, static_cast<std::int32_t>(v * 32), acc(r, v));
+        as.add(RAX, RCX);
+    }
+
+    as.add(R10, static_cast<std::int32_t>(width * 4));
+    as.add(R11, static_cast<std::int32_t>(width * 4));
+    as.dec(R9);
+    as.jnz(col_loop);
+
+    as.add(RDI, static_cast<std::int32_t>(block.rows * PACK_ROW));
+    for (std::size_t r{}; r < block.rows; ++r)
+        as.add(RDX, RCX);
+    as.dec(R8);
+    as.jnz(row_loop);
+
+    as.vzeroupper();
+    as.ret();
+    return as.code();
+}
+
+// =================================================================
+// SECTION: CACHE
+// =================================================================
+
+struct ShapeHash {
+    std::size_t operator()(const Shape& shape) const {
+        return shape.rows | shape.cols << 8 | shape.depth << 16;
+    }
+};
+
+class Cache {
+public:
+    // A product touches at most 8 shapes (full or ragged in each of rows,
+    // cols and depth), so this covers every size a process is likely to
+    // mix while keeping the executable pages to a few MiB. Pages are never
+    // freed: other threads may still hold a kernel through kernel()'s
+    // per-thread memo.
+    static constexpr std::size_t CAPACITY = 1024;
+
+private:
+    std::shared_mutex mutex_;
+    std::unordered_map<Shape, Kernel, ShapeHash> kernels_;
+    std::atomic<bool> enabled_{true};
+    const bool supported_;
+
+    // Copies code into fresh pages and flips them to read + execute.
+    static Kernel install(const std::vector<std::uint8_t>& code) {
+        const std::size_t bytes = (code.size() + 4095) / 4096 * 4096;
+        void* pages = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (pages == MAP_FAILED)
+            return nullptr;
+        std::memcpy(pages, code.data(), code.size());
+        if (mprotect(pages, bytes, PROT_READ | PROT_EXEC) != 0) {
+            munmap(pages, bytes);
+            return nullptr;
+        }
+        return reinterpret_cast<Kernel>(pages);
+    }
+
+public:
+    Cache()
+        : supported_(__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) {}
+
+    bool enabled() const {
+        return supported_ && enabled_.load(std::memory_order_relaxed);
+    }
+
+    void set_enabled(bool enabled) {
+        enabled_.store(enabled, std::memory_order_relaxed);
+    }
+
+    std::size_t size() {
+        std::shared_lock lock(mutex_);
+        return kernels_.size();
+    }
+
+    Kernel get(const Shape& shape) {
+        if (!enabled())
+            return nullptr;
+        {
+            std::shared_lock lock(mutex_);
+            if (const auto it = kernels_.find(shape); it != kernels_.end())
+                return it->second;
+        }
+        std::unique_lock lock(mutex_);
+        if (const auto it = kernels_.find(shape); it != kernels_.end())
+            return it->second;
+        if (kernels_.size() == CAPACITY)
+            return nullptr;
+        const Kernel kernel = install(generate(shape));
+        kernels_.emplace(shape, kernel);
+        return kernel;
+    }
+};
+
+inline Cache& cache() {
+    static Cache instance;
+    return instance;
+}
+
+inline bool enabled() { return cache().enabled(); }
+inline void set_enabled(bool enabled) { cache().set_enabled(enabled); }
+inline std::size_t cached_kernels() { return cache().size(); }
+
+// The kernel for `shape`, generated on first use; nullptr when JIT is off.
+// The last hit is remembered per thread, so a tile loop pays for the shared
+// lookup only when the shape changes.
+inline Kernel kernel(const Shape& shape) {
+    thread_local Shape last{};
+    thread_local Kernel last_kernel = nullptr;
+    if (last_kernel != nullptr && shape == last && enabled())
+        return last_kernel;
+
+    last = shape;
+    last_kernel = cache().get(shape);
+    return last_kernel;
+}
+
+} // namespace jit
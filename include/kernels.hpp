@@ -0,0 +1,784 @@
+#pragma once
+
+// Packing and register-blocked kernels shared by SquareMatrix and Matrix.
+// Operands are addressed through a row stride, so any row-major buffer whose
+// rows start 64-byte aligned and whose padded extents are multiples of
+// REGISTER_TILE can be fed through the same engine.
+
+#include "aligned_allocator.hpp"
+#include "half.hpp"
+#include "semiring.hpp"
+#include "trace.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+#include <experimental/simd>
+#include <immintrin.h>
+
+#if defined(GEMM_JIT)
+#include "jit.hpp"
+#endif
+
+namespace stdx = std::experimental::parallelism_v2;
+
+namespace kernels {
+
+#if defined(__AVX2__)
+inline constexpr std::size_t SIMD_SIZE = 8;
+#elif defined(__SSE2__)
+inline constexpr std::size_t SIMD_SIZE = 4;
+#else
+inline constexpr std::size_t SIMD_SIZE = 1; // Scalar fallback
+#endif
+
+template<typename T>
+using simd_t = stdx::fixed_size_simd<T, SIMD_SIZE>;
+
+// Tile edge of the 6x2 register kernel; also the padding granularity of
+// every matrix buffer.
+inline constexpr std::size_t REGISTER_TILE = 48;
+
+constexpr std::size_t padded(std::size_t n) {
+    return (n + REGISTER_TILE - 1) / REGISTER_TILE * REGISTER_TILE;
+}
+
+template<typename T, std::size_t TILE_SIZE>
+using Pack = std::array<T, TILE_SIZE * TILE_SIZE>;
+
+template<std::size_t COUNT, std::size_t STRIDE=1, std::size_t I=0>
+constexpr void unroll(auto&& fn) {
+    if constexpr (I < COUNT) {
+        fn.template operator()<I>();
+        unroll<COUNT, STRIDE, I + STRIDE>(fn);
+    }
+}
+
+// =================================================================
+// SECTION: PACKING
+// Sources are padded like every matrix buffer here: rows start vector
+// aligned, the stride and the padded row count are multiples of 48, and
+// offsets are multiples of SIMD_SIZE (tile edges are 32 or 48). Packing may
+// therefore read a partial vector or transpose block past the limits; those
+// lanes are always inside the padding and are zeroed in the pack.
+// =================================================================
+
+// pack[row * TILE_SIZE + col] = mat[row + row_offset, col + col_offset] for
+// row < row_limit, col < col_limit, `pad` elsewhere. Only whole aligned
+// vectors are moved; the fringe is masked rather than cleared up front.
+template<typename T, std::size_t TILE_SIZE, bool PREFETCH = false>
+void pack_tile_linearly(
+    const T* mat,
+    std::size_t stride,
+    std::size_t row_offset,
+    std::size_t col_offset,
+    std::size_t row_limit,
+    std::size_t col_limit,
+    Pack<T, TILE_SIZE>& pack,
+    T pad = T{}
+) {
+    static_assert(TILE_SIZE % SIMD_SIZE == 0);
+    GEMM_TRACE_SPAN(PACK);
+
+    const std::size_t full_cols = col_limit / SIMD_SIZE * SIMD_SIZE;
+    const simd_t<T> lane([](auto i) { return static_cast<T>(i); });
+    const auto fringe = lane >= static_cast<T>(col_limit - full_cols);
+
+    for (std::size_t row{}; row < row_limit; ++row) {
+        const T* src = mat + (row + row_offset) * stride + col_offset;
+        T* dst = pack.data() + row * TILE_SIZE;
+        if constexpr (PREFETCH)
+            _mm_prefetch(reinterpret_cast<const char*>(src + stride), _MM_HINT_T0);
+
+        std::size_t col{};
+        for (; col < full_cols; col += SIMD_SIZE)
+            simd_t<T>(src + col, stdx::vector_aligned).copy_to(dst + col, stdx::vector_aligned);
+        if (col < col_limit) {
+            simd_t<T> tail(src + col, stdx::vector_aligned);
+            stdx::where(fringe, tail) = pad;
+            tail.copy_to(dst + col, stdx::vector_aligned);
+            col += SIMD_SIZE;
+        }
+        for (; col < TILE_SIZE; col += SIMD_SIZE)
+            simd_t<T>(pad).copy_to(dst + col, stdx::vector_aligned);
+    }
+    std::fill(pack.begin() + row_limit * TILE_SIZE, pack.end(), pad);
+}
+
+// dst[col * dst_stride + row] = src[row * src_stride + col] for row < rows,
+// col < cols. 4-byte elements go through 8x8 (AVX2) or 4x4 (SSE) in-register
+// transposes; the ragged edge and other element sizes are copied scalar.
+template<typename T>
+void transpose(
+    const T* src, std::size_t src_stride,
+    T* dst,       std::size_t dst_stride,
+    std::size_t rows,
+    std::size_t cols
+) {
+    std::size_t block_rows{}, block_cols{};
+
+#if defined(__AVX2__)
+    if constexpr (sizeof(T) == 4) {
+        block_rows = rows / 8 * 8;
+        block_cols = cols / 8 * 8;
+        for (std::size_t r{}; r < block_rows; r += 8) {
+            for (std::size_t c{}; c < block_cols; c += 8) {
+                __m256 in[8], lo[4], hi[4];
+                for (std::size_t i{}; i < 8; ++i)
+                    in[i] = _mm256_loadu_ps(reinterpret_cast<const float*>(src + (r + i) * src_stride + c));
+
+                for (std::size_t i{}; i < 4; ++i) {
+                    lo[i] = _mm256_unpacklo_ps(in[i * 2], in[i * 2 + 1]);
+                    hi[i] = _mm256_unpackhi_ps(in[i * 2], in[i * 2 + 1]);
+                }
+                for (std::size_t i{}; i < 2; ++i) {
+                    in[i * 4 + 0] = _mm256_shuffle_ps(lo[i * 2], lo[i * 2 + 1], _MM_SHUFFLE(1, 0, 1, 0));
+                    in[i * 4 + 1] = _mm256_shuffle_ps(lo[i * 2], lo[i * 2 + 1], _MM_SHUFFLE(3, 2, 3, 2));
+                    in[i * 4 + 2] = _mm256_shuffle_ps(hi[i * 2], hi[i * 2 + 1], _MM_SHUFFLE(1, 0, 1, 0));
+                    in[i * 4 + 3] = _mm256_shuffle_ps(hi[i * 2], hi[i * 2 + 1], _MM_SHUFFLE(3, 2, 3, 2));
+                }
+
+                // in[i] holds columns i and i + 4 of rows 0-3, in[i + 4] of rows 4-7
+                for (std::size_t i{}; i < 4; ++i) {
+                    _mm256_storeu_ps(
+                        reinterpret_cast<float*>(dst + (c + i) * dst_stride + r),
+                        _mm256_permute2f128_ps(in[i], in[i + 4], 0x20)
+                    );
+                    _mm256_storeu_ps(
+                        reinterpret_cast<float*>(dst + (c + i + 4) * dst_stride + r),
+                        _mm256_permute2f128_ps(in[i], in[i + 4], 0x31)
+                    );
+                }
+            }
+        }
+    }
+#elif defined(__SSE2__)
+    if constexpr (sizeof(T) == 4) {
+        block_rows = rows / 4 * 4;
+        block_cols = cols / 4 * 4;
+        for (std::size_t r{}; r < block_rows; r += 4) {
+            for (std::size_t c{}; c < block_cols; c += 4) {
+                __m128 in[4];
+                for (std::size_t i{}; i < 4; ++i)
+                    in[i] = _mm_loadu_ps(reinterpret_cast<const float*>(src + (r + i) * src_stride + c));
+                _MM_TRANSPOSE4_PS(in[0], in[1], in[2], in[3]);
+                for (std::size_t i{}; i < 4; ++i)
+                    _mm_storeu_ps(reinterpret_cast<float*>(dst + (c + i) * dst_stride + r), in[i]);
+            }
+        }
+    }
+#endif
+
+    for (std::size_t r{}; r < block_rows; ++r)
+        for (std::size_t c = block_cols; c < cols; ++c)
+            dst[c * dst_stride + r] = src[r * src_stride + c];
+    for (std::size_t r = block_rows; r < rows; ++r)
+        for (std::size_t c{}; c < cols; ++c)
+            dst[c * dst_stride + r] = src[r * src_stride + c];
+}
+
+// pack[col * TILE_SIZE + row] = mat[row + row_offset, col + col_offset]: the
+// tile packed transposed. Limits are rounded up to whole transpose blocks,
+// then only the fringe is cleared.
+template<typename T, std::size_t TILE_SIZE>
+void pack_tile_transposed(
+    const T* mat,
+    std::size_t stride,
+    std::size_t row_offset,
+    std::size_t col_offset,
+    std::size_t row_limit,
+    std::size_t col_limit,
+    Pack<T, TILE_SIZE>& pack
+) {
+    GEMM_TRACE_SPAN(PACK);
+    static constexpr std::size_t BLOCK = sizeof(T) == 4 ? SIMD_SIZE : 1;
+    static_assert(TILE_SIZE % BLOCK == 0);
+
+    const std::size_t block_rows = (row_limit + BLOCK - 1) / BLOCK * BLOCK;
+    const std::size_t block_cols = (col_limit + BLOCK - 1) / BLOCK * BLOCK;
+    transpose(mat + row_offset * stride + col_offset, stride, pack.data(), TILE_SIZE, block_rows, block_cols);
+
+    if (block_rows < TILE_SIZE || row_limit < block_rows)
+        for (std::size_t col{}; col < col_limit; ++col)
+            std::fill(pack.begin() + col * TILE_SIZE + row_limit, pack.begin() + (col + 1) * TILE_SIZE, T{});
+    std::fill(pack.begin() + col_limit * TILE_SIZE, pack.end(), T{});
+}
+
+// =================================================================
+// SECTION: TILED REGISTERS + SIMD
+// ON AMD x86-64 :: AVX2 :: 16 YMM regs :: 12(C) + 2(B) + 1(A) = 15
+// =================================================================
+
+// a_pack and b_pack are row-major TILE_SIZE x TILE_SIZE tiles, vector
+// aligned: a Pack, or a tile stored in place by a tiled layout. Only the
+// first `rows` rows of C (rounded up to 6) are updated, for callers whose
+// A tile is known to be zero below that. Products and sums are those of
+// the semiring S (semiring.hpp).
+template<typename T, std::size_t TILE_SIZE, typename S = semiring::PlusTimes>
+void microkernel_6x2(
+    const T* a_pack,
+    const T* b_pack,
+    T* C,
+    std::size_t stride,
+    std::size_t row_offset,
+    std::size_t col_offset,
+    std::size_t rows = TILE_SIZE
+) {
+    GEMM_TRACE_SPAN(MICROKERNEL);
+    static constexpr std::size_t N_ROWS = 6;
+    static constexpr std::size_t N_COLS = 2;
+    static constexpr std::size_t C_REGS = N_ROWS * N_COLS;
+
+    auto c_index = [&](std::size_t col, std::size_t row) {
+        return (row + row_offset) * stride + col + col_offset;
+    };
+
+    std::array<simd_t<T>, C_REGS> c_regs;
+    std::array<simd_t<T>, N_COLS> b_regs;
+
+    for (std::size_t row{}; row < rows; row += N_ROWS) {
+        for (std::size_t col{}; col < TILE_SIZE; col += (N_COLS * SIMD_SIZE)) {
+            {
+                GEMM_TRACE_SPAN(C_LOAD);
+                unroll<N_ROWS>([&]<std::size_t r> {
+                    unroll<N_COLS>([&]<std::size_t c> {
+                        c_regs[r * N_COLS + c].copy_from(
+                            C + c_index(col + (c * SIMD_SIZE), row + r),
+                            stdx::vector_aligned
+                        );
+                    });
+                });
+            }
+
+            for (std::size_t k{}; k < TILE_SIZE; ++k) {
+                b_regs[0].copy_from(&b_pack[k * TILE_SIZE + col], stdx::vector_aligned);
+                b_regs[1].copy_from(&b_pack[k * TILE_SIZE + col + SIMD_SIZE], stdx::vector_aligned);
+
+                unroll<N_ROWS>([&]<std::size_t i> {
+                    const auto a = simd_t<T>(a_pack[(row + i) * TILE_SIZE + k]);
+                    c_regs[i * 2 + 0] = S::add(c_regs[i * 2 + 0], S::mul(a, b_regs[0]));
+                    c_regs[i * 2 + 1] = S::add(c_regs[i * 2 + 1], S::mul(a, b_regs[1]));
+                });
+            }
+
+            GEMM_TRACE_SPAN(C_STORE);
+            unroll<N_ROWS>([&]<std::size_t r> {
+                unroll<N_COLS>([&]<std::size_t c> {
+                    c_regs[r * N_COLS + c].copy_to(
+                        C + c_index(col + (c * SIMD_SIZE), row + r),
+                        stdx::vector_aligned
+                    );
+                });
+            });
+        }
+    }
+}
+
+// Logical extents of a product inside its padded buffers. Only the JIT
+// kernels look at them, to skip the zero padding of ragged edge tiles.
+struct Extents {
+    std::size_t rows = SIZE_MAX;
+    std::size_t cols = SIZE_MAX;
+    std::size_t depth = SIZE_MAX;
+};
+
+// C tile at (row_offset, col_offset) += a_pack * b_pack, where only the
+// leading rows x cols x depth of the packs can be non-zero. Goes through a
+// generated kernel for that exact shape when built with GEMM_JIT; the
+// register kernel skips the zero rows below `rows`.
+template<typename T, std::size_t TILE_SIZE, typename S = semiring::PlusTimes>
+void multiply_tile(
+    const T* a_pack,
+    const T* b_pack,
+    T* C,
+    std::size_t stride,
+    std::size_t row_offset,
+    std::size_t col_offset,
+    std::size_t rows,
+    [[maybe_unused]] std::size_t cols,
+    [[maybe_unused]] std::size_t depth
+) {
+#if defined(GEMM_JIT)
+    if constexpr (std::is_same_v<T, float> && TILE_SIZE == jit::TILE && std::is_same_v<S, semiring::PlusTimes>) {
+        if (const jit::Kernel kernel = jit::kernel({rows, cols, depth})) {
+            GEMM_TRACE_SPAN(MICROKERNEL);
+            kernel(a_pack, b_pack, C + row_offset * stride + col_offset, stride * sizeof(T));
+            return;
+        }
+    }
+#endif
+    microkernel_6x2<T, TILE_SIZE, S>(a_pack, b_pack, C, stride, row_offset, col_offset, rows);
+}
+
+// C[row_begin:row_end, col_begin:col_end] += A[row_begin:row_end, :] * B[:, col_begin:col_end]
+// All bounds and `depth` are multiples of REGISTER_TILE. For semirings
+// other than (+, *), `extents.depth` must be the logical depth: the A
+// columns past it are packed as S::zero rather than read as 0.
+template<typename T, typename S = semiring::PlusTimes>
+void multiply_block(
+    const T* a_ptr, std::size_t a_stride,
+    const T* b_ptr, std::size_t b_stride,
+    T* c_ptr,       std::size_t c_stride,
+    std::size_t row_begin, std::size_t row_end,
+    std::size_t col_begin, std::size_t col_end,
+    std::size_t depth,
+    Extents extents = {}
+) {
+    static constexpr std::size_t TILE_SIZE = REGISTER_TILE;
+
+    static constexpr bool PLAIN = std::is_same_v<S, semiring::PlusTimes>;
+
+    alignas(64) Pack<T, TILE_SIZE> a_pack;
+    alignas(64) Pack<T, TILE_SIZE> b_pack;
+
+    for (std::size_t i = row_begin; i < row_end; i += TILE_SIZE) {
+        GEMM_TRACE_SPAN(TILE_ROW);
+        for (std::size_t k{}; k < depth; k += TILE_SIZE) {
+            GEMM_TRACE_SPAN(TILE_PANEL);
+            const std::size_t a_cols = PLAIN ? TILE_SIZE : std::min(TILE_SIZE, extents.depth - k);
+            pack_tile_linearly<T, TILE_SIZE>(a_ptr, a_stride, i, k, TILE_SIZE, a_cols, a_pack, S::template zero<T>());
+
+            for (std::size_t j = col_begin; j < col_end; j += TILE_SIZE) {
+                pack_tile_linearly<T, TILE_SIZE>(b_ptr, b_stride, k, j, TILE_SIZE, TILE_SIZE, b_pack);
+                multiply_tile<T, TILE_SIZE, S>(
+                    a_pack.data(), b_pack.data(), c_ptr, c_stride, i, j,
+                    std::min(TILE_SIZE, extents.rows - i),
+                    std::min(TILE_SIZE, extents.cols - j),
+                    std::min(TILE_SIZE, extents.depth - k)
+                );
+            }
+        }
+    }
+}
+
+// Runs fn(tile) for tile in [0, tiles), dealt round-robin to `threads`
+// workers. Callers give each tile a disjoint slice of C, so no
+// synchronisation is needed beyond the final join.
+void for_each_row_tile(std::size_t tiles, std::size_t threads, auto&& fn) {
+    threads = std::clamp<std::size_t>(threads, 1, std::max<std::size_t>(tiles, 1));
+
+    auto worker = [&](std::size_t first_tile) {
+        for (std::size_t tile = first_tile; tile < tiles; tile += threads)
+            fn(tile);
+    };
+
+    std::vector<std::jthread> pool;
+    pool.reserve(threads - 1);
+    for (std::size_t t = 1; t < threads; ++t)
+        pool.emplace_back(worker, t);
+    worker(0);
+}
+
+// C[rows x cols] += A[rows x depth] * B[depth x cols] over padded extents
+// (multiples of REGISTER_TILE), one 48-row tile of C per task. `extents`
+// optionally gives the unpadded shape, and must for semirings other than
+// (+, *); C starts out as S::zero where nothing is to be accumulated.
+template<typename T, typename S = semiring::PlusTimes>
+void multiply_tiled_registers(
+    const T* a_ptr, std::size_t a_stride,
+    const T* b_ptr, std::size_t b_stride,
+    T* c_ptr,       std::size_t c_stride,
+    std::size_t rows,
+    std::size_t cols,
+    std::size_t depth,
+    std::size_t threads = 1,
+    Extents extents = {}
+) {
+    GEMM_TRACE_SPAN(MULTIPLY);
+    static constexpr std::size_t TILE_SIZE = REGISTER_TILE;
+
+    if (threads <= 1) {
+        multiply_block<T, S>(a_ptr, a_stride, b_ptr, b_stride, c_ptr, c_stride, 0, rows, 0, cols, depth, extents);
+        return;
+    }
+
+    for_each_row_tile(rows / TILE_SIZE, threads, [&](std::size_t tile) {
+        const std::size_t i = tile * TILE_SIZE;
+        multiply_block<T, S>(a_ptr, a_stride, b_ptr, b_stride, c_ptr, c_stride, i, i + TILE_SIZE, 0, cols, depth, extents);
+    });
+}
+
+// Same product on operands stored as contiguous REGISTER_TILE^2 tiles (see
+// layout.hpp): the microkernel reads the tiles in place, nothing is packed.
+// a_tile(i, k), b_tile(k, j) and c_tile(i, j) return the tile at tile
+// coordinates (row, column).
+template<typename T>
+void multiply_tile_grid(
+    auto&& a_tile,
+    auto&& b_tile,
+    auto&& c_tile,
+    std::size_t row_tiles,
+    std::size_t col_tiles,
+    std::size_t depth_tiles,
+    std::size_t threads = 1
+) {
+    GEMM_TRACE_SPAN(MULTIPLY);
+    static constexpr std::size_t TILE_SIZE = REGISTER_TILE;
+
+    for_each_row_tile(row_tiles, threads, [&](std::size_t i) {
+        GEMM_TRACE_SPAN(TILE_ROW);
+        for (std::size_t k{}; k < depth_tiles; ++k) {
+            GEMM_TRACE_SPAN(TILE_PANEL);
+            const T* a = a_tile(i, k);
+            for (std::size_t j{}; j < col_tiles; ++j) {
+                if (j + 1 < col_tiles) {
+                    const char* next = reinterpret_cast<const char*>(b_tile(k, j + 1));
+                    for (std::size_t line{}; line < TILE_SIZE * TILE_SIZE * sizeof(T); line += 64)
+                        _mm_prefetch(next + line, _MM_HINT_T0);
+                }
+                microkernel_6x2<T, TILE_SIZE>(a, b_tile(k, j), c_tile(i, j), TILE_SIZE, 0, 0);
+            }
+        }
+    });
+}
+
+// =================================================================
+// SECTION: MIXED PRECISION (16-bit storage, fp32 accumulation)
+// =================================================================
+
+// pack_tile_linearly for 16-bit sources: the tile is widened to fp32 on the
+// way into the pack, so the fp32 microkernel runs unchanged.
+template<half_float S, std::size_t TILE_SIZE>
+void pack_tile_widened(
+    const S* mat,
+    std::size_t stride,
+    std::size_t row_offset,
+    std::size_t col_offset,
+    std::size_t row_limit,
+    std::size_t col_limit,
+    Pack<float, TILE_SIZE>& pack
+) {
+    GEMM_TRACE_SPAN(PACK);
+    for (std::size_t row{}; row < row_limit; ++row) {
+        float* dst = pack.data() + row * TILE_SIZE;
+        widen(mat + (row + row_offset) * stride + col_offset, dst, col_limit);
+        std::fill(dst + col_limit, dst + TILE_SIZE, 0.0f);
+    }
+    std::fill(pack.begin() + row_limit * TILE_SIZE, pack.end(), 0.0f);
+}
+
+// multiply_tiled_registers for 16-bit A and B. With an fp32 C the products
+// accumulate into it; with a 16-bit C each 48-row strip is summed in an
+// fp32 scratch and rounded once, overwriting C.
+template<half_float S, typename C>
+    requires (std::is_same_v<C, float> || std::is_same_v<C, S>)
+void multiply_mixed(
+    const S* a_ptr, std::size_t a_stride,
+    const S* b_ptr, std::size_t b_stride,
+    C* c_ptr,       std::size_t c_stride,
+    std::size_t rows,
+    std::size_t cols,
+    std::size_t depth,
+    std::size_t threads = 1,
+    Extents extents = {}
+) {
+    GEMM_TRACE_SPAN(MULTIPLY);
+    static constexpr std::size_t TILE_SIZE = REGISTER_TILE;
+
+    for_each_row_tile(rows / TILE_SIZE, threads, [&](std::size_t tile) {
+        GEMM_TRACE_SPAN(TILE_ROW);
+        const std::size_t i = tile * TILE_SIZE;
+        alignas(64) Pack<float, TILE_SIZE> a_pack;
+        alignas(64) Pack<float, TILE_SIZE> b_pack;
+
+        float* acc;
+        std::size_t acc_stride;
+        thread_local std::vector<float, aligned_allocator<float, 64>> scratch;
+        if constexpr (std::is_same_v<C, float>) {
+            acc = c_ptr + i * c_stride;
+            acc_stride = c_stride;
+        } else {
+            scratch.assign(TILE_SIZE * cols, 0.0f);
+            acc = scratch.data();
+            acc_stride = cols;
+        }
+
+        for (std::size_t k{}; k < depth; k += TILE_SIZE) {
+            GEMM_TRACE_SPAN(TILE_PANEL);
+            pack_tile_widened<S, TILE_SIZE>(a_ptr, a_stride, i, k, TILE_SIZE, TILE_SIZE, a_pack);
+            for (std::size_t j{}; j < cols; j += TILE_SIZE) {
+                pack_tile_widened<S, TILE_SIZE>(b_ptr, b_stride, k, j, TILE_SIZE, TILE_SIZE, b_pack);
+                multiply_tile<float, TILE_SIZE>(
+                    a_pack.data(), b_pack.data(), acc, acc_stride, 0, j,
+                    std::min(TILE_SIZE, extents.rows - i),
+                    std::min(TILE_SIZE, extents.cols - j),
+                    std::min(TILE_SIZE, extents.depth - k)
+                );
+            }
+        }
+
+        if constexpr (!std::is_same_v<C, float>)
+            for (std::size_t row{}; row < TILE_SIZE; ++row)
+                narrow(acc + row * cols, c_ptr + (i + row) * c_stride, cols);
+    });
+}
+
+// =================================================================
+// SECTION: SYRK (C = A * A^T, one triangle)
+// =================================================================
+
+// Lower (or upper) triangle of C[rows x rows] += A[rows x depth] * A^T over
+// padded extents. A is packed once as transposed tiles; that panel is the B
+// operand of every C tile, and transposing a tile of it back gives the A
+// operand, so A is read from memory only once. C tiles entirely on the
+// other side of the diagonal are skipped, halving the work; the diagonal
+// tiles are computed whole.
+template<typename T>
+void syrk_tiled_registers(
+    const T* a_ptr, std::size_t a_stride,
+    T* c_ptr,       std::size_t c_stride,
+    std::size_t rows,
+    std::size_t depth,
+    bool lower,
+    std::size_t threads = 1
+) {
+    GEMM_TRACE_SPAN(MULTIPLY);
+    static constexpr std::size_t TILE_SIZE = REGISTER_TILE;
+    static constexpr std::size_t TILE_ELEMENTS = TILE_SIZE * TILE_SIZE;
+
+    const std::size_t row_tiles = rows / TILE_SIZE;
+    const std::size_t depth_tiles = depth / TILE_SIZE;
+
+    // panel tile (j, k) = A(j, k)^T
+    std::vector<T, aligned_allocator<T, 64>> panel(rows * depth);
+    auto panel_tile = [&](std::size_t j, std::size_t k) {
+        return panel.data() + (j * depth_tiles + k) * TILE_ELEMENTS;
+    };
+
+    for_each_row_tile(row_tiles, threads, [&](std::size_t j) {
+        GEMM_TRACE_SPAN(PACK);
+        for (std::size_t k{}; k < depth_tiles; ++k)
+            transpose(a_ptr + j * TILE_SIZE * a_stride + k * TILE_SIZE, a_stride, panel_tile(j, k), TILE_SIZE, TILE_SIZE, TILE_SIZE);
+    });
+
+    for_each_row_tile(row_tiles, threads, [&](std::size_t i) {
+        GEMM_TRACE_SPAN(TILE_ROW);
+        alignas(64) Pack<T, TILE_SIZE> a_pack;
+        const std::size_t first = lower ? 0 : i;
+        const std::size_t last = lower ? i + 1 : row_tiles;
+
+        for (std::size_t k{}; k < depth_tiles; ++k) {
+            GEMM_TRACE_SPAN(TILE_PANEL);
+            transpose(panel_tile(i, k), TILE_SIZE, a_pack.data(), TILE_SIZE, TILE_SIZE, TILE_SIZE);
+            for (std::size_t j = first; j < last; ++j)
+                microkernel_6x2<T, TILE_SIZE>(a_pack.data(), panel_tile(j, k), c_ptr, c_stride, i * TILE_SIZE, j * TILE_SIZE);
+        }
+    });
+}
+
+// Zeroes what syrk_tiled_registers wrote on the wrong side of the diagonal
+// inside the diagonal tiles, leaving exactly one triangle.
+template<typename T>
+void clear_opposite_triangle(T* c_ptr, std::size_t c_stride, std::size_t rows, bool lower) {
+    for (std::size_t y{}; y < rows; ++y) {
+        T* row = c_ptr + y * c_stride;
+        const std::size_t tile_begin = y / REGISTER_TILE * REGISTER_TILE;
+        if (lower)
+            std::fill(row + y + 1, row + tile_begin + REGISTER_TILE, T{});
+        else
+            std::fill(row + tile_begin, row + y, T{});
+    }
+}
+
+// =================================================================
+// SECTION: SEMIRINGS (products over semiring.hpp policies)
+// =================================================================
+
+// C = A * B over the semiring S, on padded buffers whose logical shape is
+// `extents`. C is reset to S::zero, so nothing is accumulated; afterwards
+// its padding is put back to T{}, the invariant every caller relies on.
+template<typename S, typename T>
+void multiply_semiring(
+    const T* a_ptr, std::size_t a_stride,
+    const T* b_ptr, std::size_t b_stride,
+    T* c_ptr, std::size_t c_stride,
+    std::size_t rows, std::size_t cols, std::size_t depth,
+    Extents extents,
+    std::size_t threads = 1
+) {
+    std::fill(c_ptr, c_ptr + rows * c_stride, S::template zero<T>());
+    multiply_tiled_registers<T, S>(a_ptr, a_stride, b_ptr, b_stride, c_ptr, c_stride, rows, cols, depth, threads, extents);
+
+    for (std::size_t y{}; y < rows; ++y) {
+        T* row = c_ptr + y * c_stride;
+        std::fill(row + (y < extents.rows ? extents.cols : 0), row + c_stride, T{});
+    }
+}
+
+// =================================================================
+// SECTION: TRSM AND LU (solvers on the register-blocked engine)
+// =================================================================
+
+// C[rows x cols] -= A[rows x depth] * B[depth x cols] over padded extents.
+// A is copied negated into a scratch panel so the update runs on the
+// accumulating register kernel; the copy is O(rows * depth) next to the
+// O(rows * cols * depth) product.
+template<typename T>
+void subtract_product(
+    const T* a_ptr, std::size_t a_stride,
+    const T* b_ptr, std::size_t b_stride,
+    T* c_ptr,       std::size_t c_stride,
+    std::size_t rows,
+    std::size_t cols,
+    std::size_t depth,
+    std::size_t threads
+) {
+    thread_local std::vector<T, aligned_allocator<T, 64>> negated;
+    negated.resize(rows * depth);
+    for (std::size_t i{}; i < rows; ++i)
+        for (std::size_t k{}; k < depth; ++k)
+            negated[i * depth + k] = -a_ptr[i * a_stride + k];
+    multiply_tiled_registers(negated.data(), depth, b_ptr, b_stride, c_ptr, c_stride, rows, cols, depth, threads);
+}
+
+// B[n x cols] = T^-1 * B for the lower or upper triangle of T[n x n]. n and
+// cols are logical extents; both buffers are padded. Each 48-row diagonal
+// block is solved by substitution, whole rows of B at a time, and the rest
+// of B takes a rank-48 update through subtract_product, so all but about
+// 24 / n of the flops run on the register kernel.
+template<std::floating_point T>
+void trsm_left(
+    const T* t_ptr, std::size_t t_stride,
+    T* b_ptr,       std::size_t b_stride,
+    std::size_t n,
+    std::size_t cols,
+    bool lower,
+    bool unit,
+    std::size_t threads = 1
+) {
+    static constexpr std::size_t TILE_SIZE = REGISTER_TILE;
+    const std::size_t width = padded(cols);
+
+    auto eliminate = [&](std::size_t i, std::size_t j) {
+        const T factor = t_ptr[i * t_stride + j];
+        T* row = b_ptr + i * b_stride;
+        const T* pivot_row = b_ptr + j * b_stride;
+        for (std::size_t c{}; c < width; ++c)
+            row[c] -= factor * pivot_row[c];
+    };
+    auto scale = [&](std::size_t i) {
+        if (unit)
+            return;
+        const T inverse = T{1} / t_ptr[i * t_stride + i];
+        T* row = b_ptr + i * b_stride;
+        for (std::size_t c{}; c < width; ++c)
+            row[c] *= inverse;
+    };
+
+    const std::size_t blocks = padded(n) / TILE_SIZE;
+    for (std::size_t step{}; step < blocks; ++step) {
+        const std::size_t block = lower ? step : blocks - 1 - step;
+        const std::size_t first = block * TILE_SIZE;
+        const std::size_t last = std::min(first + TILE_SIZE, n);
+
+        if (lower) {
+            for (std::size_t i = first; i < last; ++i) {
+                for (std::size_t j = first; j < i; ++j)
+                    eliminate(i, j);
+                scale(i);
+            }
+            if (last < n) {
+                subtract_product(
+                    t_ptr + last * t_stride + first, t_stride,
+                    b_ptr + first * b_stride,        b_stride,
+                    b_ptr + last * b_stride,         b_stride,
+                    padded(n) - last, width, TILE_SIZE, threads
+                );
+            }
+        } else {
+            for (std::size_t i = last; i-- > first;) {
+                for (std::size_t j = i + 1; j < last; ++j)
+                    eliminate(i, j);
+                scale(i);
+            }
+            if (first > 0) {
+                subtract_product(
+                    t_ptr + first,            t_stride,
+                    b_ptr + first * b_stride, b_stride,
+                    b_ptr,                    b_stride,
+                    first, width, TILE_SIZE, threads
+                );
+            }
+        }
+    }
+}
+
+// Right-looking LU with partial pivoting of A[n x n], in place: the strict
+// lower triangle becomes L (its unit diagonal implied), the rest U, and
+// row i was swapped with row pivots[i] at step i. Each 48-column panel is
+// factored by unblocked elimination, the block row of U right of it is a
+// unit-lower trsm_left, and the trailing matrix takes a rank-48 update on
+// the register kernel, which does all but about 72 / n of the flops.
+// Returns false when a pivot is exactly zero (A is singular); the factors
+// are still completed, as LAPACK's getrf does.
+template<std::floating_point T>
+bool lu_factor(T* a_ptr, std::size_t stride, std::size_t n, std::span<std::size_t> pivots, std::size_t threads = 1) {
+    static constexpr std::size_t TILE_SIZE = REGISTER_TILE;
+    auto at = [&](std::size_t row, std::size_t col) -> T& { return a_ptr[row * stride + col]; };
+
+    bool regular = true;
+    for (std::size_t first{}; first < n; first += TILE_SIZE) {
+        const std::size_t last = std::min(first + TILE_SIZE, n);
+
+        for (std::size_t j = first; j < last; ++j) {
+            std::size_t pivot = j;
+            for (std::size_t i = j + 1; i < n; ++i)
+                if (std::abs(at(i, j)) > std::abs(at(pivot, j)))
+                    pivot = i;
+            pivots[j] = pivot;
+
+            if (at(pivot, j) == T{}) {
+                regular = false;
+                continue;
+            }
+            if (pivot != j)
+                std::swap_ranges(&at(j, 0), &at(j, 0) + n, &at(pivot, 0));
+
+            const T inverse = T{1} / at(j, j);
+            for (std::size_t i = j + 1; i < n; ++i) {
+                const T factor = at(i, j) *= inverse;
+                for (std::size_t c = j + 1; c < last; ++c)
+                    at(i, c) -= factor * at(j, c);
+            }
+        }
+
+        if (last == n)
+            break;
+        trsm_left(&at(first, first), stride, &at(first, last), stride, last - first, n - last, true, true, threads);
+        subtract_product(
+            &at(last, first), stride,
+            &at(first, last), stride,
+            &at(last, last),  stride,
+            padded(n) - last, padded(n) - last, TILE_SIZE, threads
+        );
+    }
+    return regular;
+}
+
+// B = A^-1 * B given lu_factor's output for A: the row swaps, then a
+// unit-lower and an upper solve.
+template<std::floating_point T>
+void lu_solve(
+    const T* lu_ptr, std::size_t lu_stride,
+    std::span<const std::size_t> pivots,
+    T* b_ptr,        std::size_t b_stride,
+    std::size_t n,
+    std::size_t cols,
+    std::size_t threads = 1
+) {
+    for (std::size_t i{}; i < n; ++i)
+        if (pivots[i] != i)
+            std::swap_ranges(b_ptr + i * b_stride, b_ptr + i * b_stride + cols, b_ptr + pivots[i] * b_stride);
+    trsm_left(lu_ptr, lu_stride, b_ptr, b_stride, n, cols, true, true, threads);
+    trsm_left(lu_ptr, lu_stride, b_ptr, b_stride, n, cols, false, false, threads);
+}
+
+} // namespace kernels
@@ -0,0 +1,61 @@
+#pragma once
+
+// Storage layouts for SquareMatrix.
+//
+// RowMajor is the classic padded row-major buffer. The tiled layouts split
+// the padded matrix into REGISTER_TILE x REGISTER_TILE tiles, each stored
+// contiguously and row-major, so the register kernel reads them in place
+// without packing and large power-of-two N no longer maps the rows of a
+// tile onto the same cache sets. They differ only in the order of the
+// tiles: BlockMajor walks tile rows, Morton follows the Z-order curve so
+// tiles close in 2D stay close in memory at every scale.
+
+#include "kernels.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+
+namespace layout {
+
+struct RowMajor {
+    static constexpr bool TILED = false;
+};
+
+struct BlockMajor {
+    static constexpr bool TILED = true;
+
+    static constexpr std::size_t tile_rank(std::size_t row, std::size_t col, std::size_t grid) {
+        return row * grid + col;
+    }
+};
+
+// Dense Z-order rank of tile (row, col) in a grid x grid tile grid. The
+// grid is rarely a power of two, so the curve is walked over the enclosing
+// power-of-two square and every quadrant passed over adds only its tiles
+// that exist. No storage is wasted on the missing ones.
+struct Morton {
+    static constexpr bool TILED = true;
+
+    static constexpr std::size_t tile_rank(std::size_t row, std::size_t col, std::size_t grid) {
+        auto overlap = [grid](std::size_t begin, std::size_t size) -> std::size_t {
+            return begin >= grid ? 0 : std::min(size, grid - begin);
+        };
+
+        std::size_t rank{}, row_origin{}, col_origin{};
+        for (std::size_t size = std::bit_ceil(grid); size > 1; size /= 2) {
+            const std::size_t half = size / 2;
+            const std::size_t quadrant_row = row >= row_origin + half;
+            const std::size_t quadrant_col = col >= col_origin + half;
+
+            for (std::size_t q{}; q < quadrant_row * 2 + quadrant_col; ++q)
+                rank += overlap(row_origin + (q / 2) * half, half) * overlap(col_origin + (q % 2) * half, half);
+
+            row_origin += quadrant_row * half;
+            col_origin += quadrant_col * half;
+        }
+        return rank;
+    }
+};
+
+} // namespace layout
@@ -1,40 +1,45 @@
 #pragma once
 
 #include "aligned_allocator.hpp"
+#include "dispatch.hpp"
 #include "huge_page_allocator.hpp"
+#include "kernels.hpp"
+#include "layout.hpp"
+#include "philox.hpp"
+#include "trace.hpp"
 
+#include <algorithm>
 #include <array>
+#include <cassert>
+#include <concepts>
+#include <cstdint>
 #include <experimental/bits/simd.h>
 #include <vector>
 #include <random>
+#include <span>
 #include <print>
 #include <type_traits>
 
 #include <experimental/simd>
 
-namespace stdx = std::experimental::parallelism_v2;
-
-enum class Impl: char { 
-    NAIVE, 
-    TRANSPOSED, TRANSPOSED_SIMD, 
-    TILED,      TILED_SIMD,      TILED_PREFETCH,    TILED_REGISTERS
-};
-
-template<typename T, std::size_t N> requires (N%4==0)
+// Layout is one of the policies in layout.hpp. Tiled layouts support
+// Impl::NAIVE and Impl::TILED_REGISTERS and keep no transposed copy.
+template<typename T, std::size_t N, typename Layout = layout::RowMajor> requires (N%4==0)
 class SquareMatrix {
 private:
-#if defined(__AVX2__)
-    static constexpr std::size_t SIMD_SIZE = 8;
-#elif defined(__SSE2__)
-    static constexpr std::size_t SIMD_SIZE = 4;
-#else
-    static constexpr std::size_t SIMD_SIZE = 1; // Scalar fallback
-#endif    
-
-    static constexpr std::size_t MAT_WIDTH = std::ceil(double(N) / 48.0) * 48ULL;
+    template<typename U, std::size_t M, typename L> requires (M%4==0)
+    friend class SquareMatrix;
+
+    static constexpr std::size_t SIMD_SIZE = kernels::SIMD_SIZE;
+
+    static constexpr std::size_t MAT_WIDTH = kernels::padded(N);
     static constexpr std::size_t MAT_SIZE  = MAT_WIDTH * MAT_WIDTH;
 
-    using simd_t = stdx::fixed_size_simd<T, SIMD_SIZE>;
+    static constexpr bool TILED = Layout::TILED;
+    static constexpr std::size_t TILE = kernels::REGISTER_TILE;
+    static constexpr std::size_t GRID = MAT_WIDTH / TILE;
+
+    using simd_t = kernels::simd_t<T>;
 
     // static constexpr std::size_t ALIGN = stdx::memory_alignment_v<simd_t>;
     // using aligned_vector = std::vector<T, aligned_allocator<T, ALIGN>>;
@@ -45,37 +50,83 @@ private:
     aligned_vector transposed_;
 
     constexpr static inline std::size_t getIndex(std::size_t x, std::size_t y) {
-        return y * MAT_WIDTH + x;
+        if constexpr (TILED)
+            return Layout::tile_rank(y / TILE, x / TILE, GRID) * TILE * TILE + (y % TILE) * TILE + x % TILE;
+        else
+            return y * MAT_WIDTH + x;
+    }
+
+    // Tile (row, col) of a tiled layout, TILE x TILE row-major.
+    const T* tile(std::size_t row, std::size_t col) const requires TILED {
+        return matrix_.data() + Layout::tile_rank(row, col, GRID) * TILE * TILE;
+    }
+
+    T* tile(std::size_t row, std::size_t col) requires TILED {
+        return matrix_.data() + Layout::tile_rank(row, col, GRID) * TILE * TILE;
     }
 
 public:
 
+    // Integers uniform in [lower_bound, upper_bound], drawn from a fresh seed.
     static SquareMatrix make_random(T lower_bound, T upper_bound) {
-        thread_local std::random_device rd; 
-        thread_local std::mt19937 gen(rd()); 
-        std::uniform_int_distribution<> distrib(lower_bound, upper_bound); 
-
-        SquareMatrix random_matrix{};
-        for (std::size_t x = 0; x < N; ++x) 
-            for (std::size_t y = 0; y < N; ++y) 
-                random_matrix.matrix_[getIndex(x,y)] = distrib(gen);
+        thread_local std::mt19937_64 seeds(std::random_device{}());
+        return make_random(lower_bound, upper_bound, seeds(), 0);
+    }
 
-        random_matrix.compute_transpose();
+    // The same matrix for the same seed whatever `threads` is (0: every
+    // hardware thread). 48-row tiles are spread over the threads, each
+    // writing its rows of the matrix and of the transposed copy in storage
+    // order (see philox.hpp).
+    static SquareMatrix make_random(T lower_bound, T upper_bound, std::uint64_t seed, std::size_t threads = 0) {
+        const philox::Range range(static_cast<std::int64_t>(lower_bound), static_cast<std::int64_t>(upper_bound));
+        if (threads == 0)
+            threads = dispatch::hardware_threads();
 
+        SquareMatrix random_matrix{};
+        kernels::for_each_row_tile(MAT_WIDTH / TILE, threads, [&](std::size_t tile) {
+            const std::size_t first = tile * TILE;
+            const std::size_t last = std::min(first + TILE, N);
+            for (std::size_t y = first; y < last; ++y)
+                for (std::size_t x = 0; x < N; x += TILE)
+                    philox::fill_row(&random_matrix.matrix_[getIndex(x, y)], y, x, std::min(TILE, N - x), seed, range);
+
+            if constexpr (!TILED)
+                for (std::size_t x = first; x < last; x += 4)
+                    philox::fill_transposed(&random_matrix.transposed_[getIndex(0, x)], MAT_WIDTH, x, 0, N, seed, range);
+        });
         return random_matrix;
     }
 
     constexpr SquareMatrix()
         : matrix_(MAT_SIZE)
-        , transposed_(MAT_SIZE) {}
+        , transposed_(TILED ? 0 : MAT_SIZE) {}
+
+    // Converts between layouts. Any TILE-aligned run of TILE elements in a
+    // row is contiguous in every layout, so whole tile rows are copied.
+    template<typename Other> requires (!std::is_same_v<Other, Layout>)
+    explicit SquareMatrix(const SquareMatrix<T, N, Other>& other)
+        : SquareMatrix() {
+        for (std::size_t y = 0; y < MAT_WIDTH; ++y)
+            for (std::size_t x = 0; x < MAT_WIDTH; x += TILE)
+                std::copy_n(&other.matrix_[other.getIndex(x, y)], TILE, &matrix_[getIndex(x, y)]);
+        compute_transpose();
+    }
+
+    template<typename Other>
+    SquareMatrix<T, N, Other> to() const {
+        return SquareMatrix<T, N, Other>(*this);
+    }
 
     template<typename... Args>
         requires(sizeof...(Args) == N*N && 
                  std::conjunction_v<std::is_nothrow_convertible<Args, T>...>) 
     constexpr SquareMatrix(Args&&... args) 
-        : matrix_{static_cast<T>(args)...}
-        , transposed_(MAT_SIZE) {
-        matrix_.resize(MAT_SIZE, 0);
+        : matrix_(MAT_SIZE)
+        , transposed_(TILED ? 0 : MAT_SIZE) {
+        const std::array<T, N * N> values{static_cast<T>(args)...};
+        for (std::size_t y = 0; y < N; ++y)
+            for (std::size_t x = 0; x < N; ++x)
+                matrix_[getIndex(x,y)] = values[y * N + x];
         compute_transpose();
     }
 
@@ -87,6 +138,15 @@ public:
         return matrix_.data();
     }
 
+    T* data() {
+        return matrix_.data();
+    }
+
+    // Row stride of data(), in elements.
+    static constexpr std::size_t stride() requires (!TILED) {
+        return MAT_WIDTH;
+    }
+
     const T* data_transposed() const {
         return transposed_.data();
     }
@@ -100,11 +160,38 @@ public:
         }
     }
 
+    static constexpr bool supports(Impl implementation) {
+        return !TILED || implementation == Impl::NAIVE || implementation == Impl::TILED_REGISTERS || implementation == Impl::AUTO;
+    }
+
+    // `threads` applies to Impl::TILED_REGISTERS; the other kernels are serial.
+    // Impl::AUTO picks the kernel and, up to `threads` (0: every hardware
+    // thread), the worker count; it always overwrites out.
     constexpr void multiply(
         const SquareMatrix& other, 
         SquareMatrix& out, 
-        Impl implementation = Impl::TILED_SIMD
+        Impl implementation = Impl::AUTO,
+        std::size_t threads = 0
     ) const {
+        if (implementation == Impl::AUTO) {
+            if consteval {
+                multiply_naive(other, out);
+            } else {
+                multiply_auto(other, out, threads);
+            }
+            return;
+        }
+
+        if constexpr (TILED) {
+            switch (implementation) {
+            case Impl::NAIVE:           multiply_naive(other, out); return;
+            case Impl::TILED_REGISTERS: multiply_tile_grid(other, out, threads); return;
+            default:
+                assert(supports(implementation) && "Impl not available for tiled layouts");
+                return;
+            }
+        }
+
         switch (implementation) {
         case Impl::NAIVE:           multiply_naive(other, out); return;
         case Impl::TRANSPOSED:      multiply_transposed(other, out); return;
@@ -112,11 +199,65 @@ public:
         case Impl::TILED:           multiply_tiled(other, out); return;
         case Impl::TILED_SIMD:      multiply_tiled_simd(other, out); return;
         case Impl::TILED_PREFETCH:  multiply_tiled_prefetch(other, out); return;
-        case Impl::TILED_REGISTERS: multiply_tiled_registers(other, out); return;
+        case Impl::TILED_REGISTERS: multiply_tiled_registers(other, out, threads); return;
         default: return;
         }
     }
 
+    // out = this * this^T in `triangle` only, zero elsewhere; about half the
+    // work of multiply() and no transposed copy of the operand is read.
+    void syrk(SquareMatrix& out, Triangle triangle = Triangle::LOWER, std::size_t threads = 1) const requires (!TILED) {
+        const bool lower = triangle == Triangle::LOWER;
+        std::fill(out.matrix_.begin(), out.matrix_.end(), T{});
+        kernels::syrk_tiled_registers(matrix_.data(), MAT_WIDTH, out.matrix_.data(), MAT_WIDTH, MAT_WIDTH, MAT_WIDTH, lower, threads);
+        kernels::clear_opposite_triangle(out.matrix_.data(), MAT_WIDTH, MAT_WIDTH, lower);
+    }
+
+    // out = this * other over the semiring S (semiring.hpp) on the register
+    // kernel, e.g. semiring::MinPlus for a shortest-path step.
+    template<typename S>
+    void multiply_over(const SquareMatrix& other, SquareMatrix& out, std::size_t threads = 1) const
+        requires (!TILED) {
+        kernels::multiply_semiring<S>(
+            matrix_.data(),       MAT_WIDTH,
+            other.matrix_.data(), MAT_WIDTH,
+            out.matrix_.data(),   MAT_WIDTH,
+            MAT_WIDTH, MAT_WIDTH, MAT_WIDTH,
+            kernels::Extents{N, N, N},
+            threads
+        );
+        out.compute_transpose();
+    }
+
+    // out = L and U of this matrix's LU factorization with partial pivoting,
+    // L below the diagonal (unit diagonal implied) and U on and above it;
+    // row i was swapped with row pivots[i] at step i. Returns false if this
+    // matrix is singular. Trailing updates run on the register kernel.
+    bool lu(SquareMatrix& out, std::array<std::size_t, N>& pivots, std::size_t threads = 1) const
+        requires (!TILED && std::floating_point<T>) {
+        std::copy(matrix_.begin(), matrix_.end(), out.matrix_.begin());
+        const bool regular = kernels::lu_factor(out.matrix_.data(), MAT_WIDTH, N, std::span(pivots), threads);
+        out.compute_transpose();
+        return regular;
+    }
+
+    // b = T^-1 * b, T being the `triangle` of this matrix; with
+    // Diagonal::UNIT its diagonal is taken to be all ones.
+    void trsm(SquareMatrix& b, Triangle triangle, Diagonal diagonal = Diagonal::NON_UNIT, std::size_t threads = 1) const
+        requires (!TILED && std::floating_point<T>) {
+        const bool lower = triangle == Triangle::LOWER;
+        kernels::trsm_left(matrix_.data(), MAT_WIDTH, b.matrix_.data(), MAT_WIDTH, N, N, lower, diagonal == Diagonal::UNIT, threads);
+        b.compute_transpose();
+    }
+
+    // Solves A * x = b for every column of b in place, this matrix and
+    // `pivots` being the output of A.lu().
+    void lu_solve(const std::array<std::size_t, N>& pivots, SquareMatrix& b, std::size_t threads = 1) const
+        requires (!TILED && std::floating_point<T>) {
+        kernels::lu_solve(matrix_.data(), MAT_WIDTH, std::span(pivots), b.matrix_.data(), MAT_WIDTH, N, N, threads);
+        b.compute_transpose();
+    }
+
     constexpr bool operator==(const SquareMatrix& other) const {
         for (std::size_t x = 0; x < N; ++x)
             for (std::size_t y = 0; y < N; ++y)
@@ -147,6 +288,12 @@ private:
     // =================================================================
 
     constexpr void compute_transpose() {
+        if constexpr (TILED)
+            return;
+        if !consteval {
+            kernels::transpose(matrix_.data(), MAT_WIDTH, transposed_.data(), MAT_WIDTH, N, N);
+            return;
+        }
         for (std::size_t y = 0; y < N; ++y) {
             for (std::size_t x = 0; x <= y; ++x) {
                 transposed_[getIndex(x,y)] = matrix_[getIndex(y,x)];
@@ -174,8 +321,8 @@ private:
         for (std::size_t y = 0; y < N; ++y) {
             for (std::size_t x = 0; x < N; ++x) {
                 out.matrix_[getIndex(x,y)] = 0;
-                auto a_row = matrix_.data() + y * N;
-                auto b_col = other.transposed_.data() + x * N;
+                auto a_row = matrix_.data() + getIndex(0, y);
+                auto b_col = other.transposed_.data() + getIndex(0, x);
 
                 simd_t vsum{};
                 for (std::size_t k{}; k < N; k += simd_t::size()) {
@@ -196,25 +343,6 @@ private:
     // SECTION: TILED
     // =================================================================
 
-    template<std::size_t TILE_SIZE>
-    void pack_tile_linearly(
-        const T* mat,
-        std::size_t row_offset,
-        std::size_t col_offset,
-        std::size_t row_limit,
-        std::size_t col_limit,
-        std::array<T, TILE_SIZE * TILE_SIZE>& pack
-    ) const {
-        pack.fill(0);
-        for (std::size_t row{}; row < row_limit; ++row) {
-            for (std::size_t col{}; col < col_limit; ++col) {
-                const std::size_t mat_idx  = getIndex(col + col_offset, row + row_offset);
-                const std::size_t pack_idx = row * TILE_SIZE + col;
-                pack[pack_idx] = mat[mat_idx];
-            }
-        }
-    }
-
     template<std::size_t TILE_SIZE>
     void microkernel(
         const std::array<T, TILE_SIZE * TILE_SIZE>& a_pack,
@@ -240,21 +368,21 @@ private:
         static constexpr std::size_t TILE_SIZE = 32;
 
         const T * a_ptr = matrix_.data();
-        const T * bt_ptr = other.transposed_.data();
+        const T * b_ptr = other.matrix_.data();
         T * c_ptr = out.matrix_.data();
         
-        std::array<T, TILE_SIZE * TILE_SIZE> a_pack;
-        std::array<T, TILE_SIZE * TILE_SIZE> bt_pack;
+        alignas(64) std::array<T, TILE_SIZE * TILE_SIZE> a_pack;
+        alignas(64) std::array<T, TILE_SIZE * TILE_SIZE> bt_pack;
 
         for (std::size_t i{}; i < N; i += TILE_SIZE) {
             const std::size_t i_blk = std::min(N - i, TILE_SIZE);
             for (std::size_t k{}; k < N; k += TILE_SIZE) {
                 const std::size_t k_blk = std::min(N - k, TILE_SIZE);
-                pack_tile_linearly<TILE_SIZE>(a_ptr, i, k, i_blk, k_blk, a_pack);
+                kernels::pack_tile_linearly<T, TILE_SIZE>(a_ptr, MAT_WIDTH, i, k, i_blk, k_blk, a_pack);
 
                 for (std::size_t j{}; j < N; j += TILE_SIZE) {
                     const std::size_t j_blk = std::min(N - j, TILE_SIZE);
-                    pack_tile_linearly<TILE_SIZE>(bt_ptr, j, k, j_blk, k_blk, bt_pack);
+                    kernels::pack_tile_transposed<T, TILE_SIZE>(b_ptr, MAT_WIDTH, k, j, k_blk, j_blk, bt_pack);
                     microkernel<TILE_SIZE>(a_pack, bt_pack, c_ptr, i, j, i_blk, j_blk, k_blk);
                 }
             }
@@ -265,14 +393,6 @@ private:
     // SECTION: TILED + SIMD
     // =================================================================
 
-    template<std::size_t COUNT, std::size_t STRIDE=1, std::size_t I=0>
-    constexpr void unroll(auto&& fn) const {
-        if constexpr (I < COUNT) {
-            fn.template operator()<I>();
-            unroll<COUNT, STRIDE, I + STRIDE>(fn);
-        }
-    }
-
     template<std::size_t TILE_SIZE>
     void microkernel_simd(
         const std::array<T, TILE_SIZE * TILE_SIZE>& a_pack,
@@ -288,7 +408,7 @@ private:
 
         for (std::size_t row{}; row < row_limit; row += SIMD_SIZE) {
             for (std::size_t col{}; col < col_limit; col += SIMD_SIZE) {
-                unroll<SIMD_SIZE>([&]<std::size_t i> {
+                kernels::unroll<SIMD_SIZE>([&]<std::size_t i> {
                     C_rows[i].copy_from(
                         C + getIndex(col + col_offset, row + row_offset + i), 
                         stdx::vector_aligned
@@ -299,13 +419,13 @@ private:
                     simd_t b;
                     b.copy_from(&b_pack[k * TILE_SIZE + col], stdx::vector_aligned);
 
-                    unroll<SIMD_SIZE>([&]<std::size_t r> {
+                    kernels::unroll<SIMD_SIZE>([&]<std::size_t r> {
                         const std::size_t pack_idx = (row + r) * TILE_SIZE + k;
                         C_rows[r] += simd_t(a_pack[pack_idx]) * b;
                     });
                 }
 
-                unroll<SIMD_SIZE>([&]<std::size_t i> {
+                kernels::unroll<SIMD_SIZE>([&]<std::size_t i> {
                     C_rows[i].copy_to(
                         C + getIndex(col + col_offset, row + row_offset + i), 
                         stdx::vector_aligned
@@ -329,11 +449,11 @@ private:
             const std::size_t i_blk = std::min(N - i, TILE_SIZE);
             for (std::size_t k{}; k < N; k += TILE_SIZE) {
                 const std::size_t k_blk = std::min(N - k, TILE_SIZE);
-                pack_tile_linearly<TILE_SIZE>(a_ptr, i, k, i_blk, k_blk, a_pack);
+                kernels::pack_tile_linearly<T, TILE_SIZE>(a_ptr, MAT_WIDTH, i, k, i_blk, k_blk, a_pack);
 
                 for (std::size_t j{}; j < N; j += TILE_SIZE) {
                     const std::size_t j_blk = std::min(N - j, TILE_SIZE);
-                    pack_tile_linearly<TILE_SIZE>(b_ptr, k, j, k_blk, j_blk, b_pack);
+                    kernels::pack_tile_linearly<T, TILE_SIZE>(b_ptr, MAT_WIDTH, k, j, k_blk, j_blk, b_pack);
                     microkernel_simd<TILE_SIZE>(a_pack, b_pack, c_ptr, i, j, i_blk, j_blk, k_blk);
                 }
             }
@@ -344,28 +464,6 @@ private:
     // SECTION: TILED + SIMD + PREFETCHER
     // =================================================================
 
-    template<std::size_t TILE_SIZE>
-    void pack_tile_linearly_prefetched(
-        const T* mat,
-        std::size_t row_offset,
-        std::size_t col_offset,
-        std::size_t row_limit,
-        std::size_t col_limit,
-        std::array<T, TILE_SIZE * TILE_SIZE>& pack
-    ) const {
-        pack.fill(0);
-        for (std::size_t row{}; row < row_limit; ++row) {
-            for (std::size_t col{}; col < col_limit; ++col) {
-                const std::size_t next_row_index  = getIndex(col + col_offset, row + row_offset + 1);
-                _mm_prefetch((const char*)&mat[next_row_index], _MM_HINT_T0);
-
-                const std::size_t mat_idx  = getIndex(col + col_offset, row + row_offset);
-                const std::size_t pack_idx = row * TILE_SIZE + col;
-                pack[pack_idx] = mat[mat_idx];
-            }
-        }
-    }
-
     void multiply_tiled_prefetch(const SquareMatrix& other, SquareMatrix& out) const {
         static constexpr std::size_t TILE_SIZE = 32;
 
@@ -380,14 +478,14 @@ private:
             const std::size_t i_blk = std::min(N - i, TILE_SIZE);
             for (std::size_t k{}; k < N; k += TILE_SIZE) {
                 const std::size_t k_blk = std::min(N - k, TILE_SIZE);
-                pack_tile_linearly_prefetched<TILE_SIZE>(a_ptr, i, k, i_blk, k_blk, a_pack);
+                kernels::pack_tile_linearly<T, TILE_SIZE, true>(a_ptr, MAT_WIDTH, i, k, i_blk, k_blk, a_pack);
 
                 for (std::size_t j{}; j < N; j += TILE_SIZE) {
                     const std::size_t next_tile_index = getIndex(k, j + TILE_SIZE);
                     _mm_prefetch((const char*)&b_ptr[next_tile_index], _MM_HINT_T1);
 
                     const std::size_t j_blk = std::min(N - j, TILE_SIZE);
-                    pack_tile_linearly_prefetched<TILE_SIZE>(b_ptr, k, j, k_blk, j_blk, b_pack);
+                    kernels::pack_tile_linearly<T, TILE_SIZE, true>(b_ptr, MAT_WIDTH, k, j, k_blk, j_blk, b_pack);
                     microkernel_simd<TILE_SIZE>(a_pack, b_pack, c_ptr, i, j, i_blk, j_blk, k_blk);
                 }
             }
@@ -395,85 +493,52 @@ private:
     }
 
     // =================================================================
-    // SECTION: TILED REGISTERS + SIMD
-    // ON AMD x86-64 :: AVX2 :: 16 YMM regs :: 12(C) + 2(B) + 1(A) = 15
+    // SECTION: TILED REGISTERS + SIMD (see kernels.hpp)
     // =================================================================
 
-    template<std::size_t TILE_SIZE>
-    void microkernel_6x2(
-        const std::array<T, TILE_SIZE * TILE_SIZE>& a_pack,
-        const std::array<T, TILE_SIZE * TILE_SIZE>& b_pack,
-        T* C,
-        std::size_t row_offset,
-        std::size_t col_offset
+    void multiply_tiled_registers(
+        const SquareMatrix& other, 
+        SquareMatrix& out, 
+        std::size_t threads
     ) const {
-        static constexpr std::size_t N_ROWS = 6;
-        static constexpr std::size_t N_COLS = 2;
-        static constexpr std::size_t C_REGS = N_ROWS * N_COLS;
-
-        std::array<simd_t, C_REGS> c_regs; 
-        std::array<simd_t, N_COLS> b_regs;
-
-        for (std::size_t row{}; row < TILE_SIZE; row += N_ROWS) {
-            for (std::size_t col{}; col < TILE_SIZE; col += (N_COLS * SIMD_SIZE)) {
-                unroll<N_ROWS>([&]<std::size_t r> {
-                    unroll<N_COLS>([&]<std::size_t c> {
-                        c_regs[r * N_COLS + c].copy_from(
-                            C + getIndex(
-                                col + col_offset + (c * SIMD_SIZE), 
-                                row + row_offset + r
-                            ), 
-                            stdx::vector_aligned
-                        );
-                    });
-                });
-
-                for (std::size_t k{}; k < TILE_SIZE; ++k) {
-                    b_regs[0].copy_from(&b_pack[k * TILE_SIZE + col], stdx::vector_aligned);
-                    b_regs[1].copy_from(&b_pack[k * TILE_SIZE + col + SIMD_SIZE], stdx::vector_aligned);
-
-                    unroll<N_ROWS>([&]<std::size_t i> {
-                        const auto a = simd_t(a_pack[(row + i) * TILE_SIZE + k]);
-                        c_regs[i * 2 + 0] += a * b_regs[0];
-                        c_regs[i * 2 + 1] += a * b_regs[1];
-                    });
-                }
-
-                unroll<N_ROWS>([&]<std::size_t r> {
-                    unroll<N_COLS>([&]<std::size_t c> {
-                        c_regs[r * N_COLS + c].copy_to(
-                            C + getIndex(
-                                col + col_offset + (c * SIMD_SIZE), 
-                                row + row_offset + r
-                            ), 
-                            stdx::vector_aligned
-                        );
-                    });
-                });
-            }
-        }
+        kernels::multiply_tiled_registers(
+            matrix_.data(),       MAT_WIDTH,
+            other.matrix_.data(), MAT_WIDTH,
+            out.matrix_.data(),   MAT_WIDTH,
+            MAT_WIDTH, MAT_WIDTH, MAT_WIDTH,
+            threads
+        );
     }
 
-    void multiply_tiled_registers(const SquareMatrix& other, SquareMatrix& out) const {
-        static constexpr std::size_t TILE_SIZE = 48;
+    // =================================================================
+    // SECTION: AUTO (see dispatch.hpp)
+    // =================================================================
 
-        const T * a_ptr = matrix_.data();
-        const T * b_ptr = other.matrix_.data();
-        T * c_ptr = out.matrix_.data();
-        
-        alignas(64) std::array<T, TILE_SIZE * TILE_SIZE> a_pack;
-        alignas(64) std::array<T, TILE_SIZE * TILE_SIZE> b_pack;
+    void multiply_auto(const SquareMatrix& other, SquareMatrix& out, std::size_t threads) const {
+        const auto engine = TILED ? dispatch::Engine::SQUARE_TILED : dispatch::Engine::SQUARE;
+        dispatch::run(dispatch::problem<T>(engine, N, N, N), threads, [&](dispatch::Choice choice) {
+            // The tiled kernels accumulate into out.
+            if (choice.impl != Impl::NAIVE && choice.impl != Impl::TRANSPOSED && choice.impl != Impl::TRANSPOSED_SIMD)
+                std::fill(out.matrix_.begin(), out.matrix_.end(), T{});
+            multiply(other, out, choice.impl, choice.threads);
+        });
+    }
 
-        for (std::size_t i{}; i < MAT_WIDTH; i += TILE_SIZE) {
-            for (std::size_t k{}; k < MAT_WIDTH; k += TILE_SIZE) {
-                pack_tile_linearly<TILE_SIZE>(a_ptr, i, k, TILE_SIZE, TILE_SIZE, a_pack);
+    // =================================================================
+    // SECTION: TILED LAYOUTS (tiles are read in place, no packing)
+    // =================================================================
 
-                for (std::size_t j{}; j < MAT_WIDTH; j += TILE_SIZE) {
-                    pack_tile_linearly<TILE_SIZE>(b_ptr, k, j, TILE_SIZE, TILE_SIZE, b_pack);
-                    microkernel_6x2<TILE_SIZE>(a_pack, b_pack, c_ptr, i, j);
-                }
-            }
-        }
+    void multiply_tile_grid(
+        const SquareMatrix& other, 
+        SquareMatrix& out, 
+        std::size_t threads
+    ) const requires TILED {
+        kernels::multiply_tile_grid<T>(
+            [&](std::size_t i, std::size_t k) { return tile(i, k); },
+            [&](std::size_t k, std::size_t j) { return other.tile(k, j); },
+            [&](std::size_t i, std::size_t j) { return out.tile(i, j); },
+            GRID, GRID, GRID,
+            threads
+        );
     }
-};
-
+};
\ No newline at end of file
@@ -0,0 +1,254 @@
+#pragma once
+
+#include "aligned_allocator.hpp"
+#include "complex_gemm.hpp"
+#include "dispatch.hpp"
+#include "half.hpp"
+#include "kernels.hpp"
+#include "mat.hpp"
+#include "philox.hpp"
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <print>
+#include <random>
+#include <type_traits>
+#include <vector>
+
+// Row-major matrix with runtime extents. Rows and columns are padded to
+// kernels::REGISTER_TILE like SquareMatrix, so the register-blocked engine
+// runs on it unchanged; the padding always holds zeros. std::complex
+// elements multiply through complex_gemm.hpp.
+template<typename T>
+class Matrix {
+private:
+    using aligned_vector = std::vector<T, aligned_allocator<T, 64>>;
+
+    std::size_t rows_;
+    std::size_t cols_;
+    std::size_t padded_rows_;
+    std::size_t stride_;
+
+    aligned_vector matrix_;
+
+    std::size_t getIndex(std::size_t x, std::size_t y) const {
+        return y * stride_ + x;
+    }
+
+public:
+
+    // Integers uniform in [lower_bound, upper_bound], drawn from a fresh seed.
+    static Matrix make_random(std::size_t rows, std::size_t cols, T lower_bound, T upper_bound) {
+        thread_local std::mt19937_64 seeds(std::random_device{}());
+        return make_random(rows, cols, lower_bound, upper_bound, seeds(), 0);
+    }
+
+    // The same matrix for the same seed whatever `threads` is (0: every
+    // hardware thread); element (y, x) matches SquareMatrix's for that seed.
+    static Matrix make_random(
+        std::size_t rows,
+        std::size_t cols,
+        T lower_bound,
+        T upper_bound,
+        std::uint64_t seed,
+        std::size_t threads = 0
+    ) {
+        const philox::Range range(static_cast<std::int64_t>(lower_bound), static_cast<std::int64_t>(upper_bound));
+        if (threads == 0)
+            threads = dispatch::hardware_threads();
+
+        Matrix random_matrix(rows, cols);
+        kernels::for_each_row_tile(random_matrix.padded_rows_ / kernels::REGISTER_TILE, threads, [&](std::size_t tile) {
+            const std::size_t first = tile * kernels::REGISTER_TILE;
+            const std::size_t last = std::min(first + kernels::REGISTER_TILE, rows);
+            for (std::size_t y = first; y < last; ++y)
+                philox::fill_row(&random_matrix.matrix_[random_matrix.getIndex(0, y)], y, 0, cols, seed, range);
+        });
+        return random_matrix;
+    }
+
+    Matrix(std::size_t rows, std::size_t cols)
+        : rows_(rows)
+        , cols_(cols)
+        , padded_rows_(kernels::padded(rows))
+        , stride_(kernels::padded(cols))
+        , matrix_(padded_rows_ * stride_) {}
+
+    std::size_t rows() const { return rows_; }
+    std::size_t cols() const { return cols_; }
+    std::size_t padded_rows() const { return padded_rows_; }
+    std::size_t stride() const { return stride_; }
+
+    const T& get(std::size_t x, std::size_t y) const {
+        return matrix_[getIndex(x, y)];
+    }
+
+    void set(std::size_t x, std::size_t y, T value) {
+        matrix_[getIndex(x, y)] = value;
+    }
+
+    const T* data() const {
+        return matrix_.data();
+    }
+
+    T* data() {
+        return matrix_.data();
+    }
+
+    void print() const {
+        for (std::size_t y = 0; y < rows_; ++y) {
+            for (std::size_t x = 0; x < cols_; ++x) {
+                std::print("{:5} ", matrix_[getIndex(x,y)]);
+            }
+            std::println();
+        }
+    }
+
+    static constexpr bool supports(Impl implementation) {
+        return implementation == Impl::NAIVE || implementation == Impl::TILED_REGISTERS || implementation == Impl::AUTO;
+    }
+
+    // out = this * other. Only the kernels reported by supports() exist for
+    // runtime extents; `threads` caps Impl::TILED_REGISTERS and Impl::AUTO
+    // (0: AUTO may use every hardware thread). bf16 and fp16 operands are
+    // summed in fp32 and written to an fp32 or 16-bit out.
+    template<typename Out>
+        requires (!complex_float<T> && (std::is_same_v<Out, T> || (half_float<T> && std::is_same_v<Out, float>)))
+    void multiply(
+        const Matrix& other,
+        Matrix<Out>& out,
+        Impl implementation = Impl::AUTO,
+        std::size_t threads = 0
+    ) const {
+        assert(cols_ == other.rows_ && "inner dimensions must agree");
+        assert(out.rows() == rows_ && out.cols() == other.cols_ && "output has the wrong shape");
+
+        switch (implementation) {
+        case Impl::NAIVE:           multiply_naive(other, out); return;
+        case Impl::TILED_REGISTERS: multiply_tiled_registers(other, out, threads); return;
+        case Impl::AUTO:
+            dispatch::run(
+                dispatch::problem<T>(dispatch::Engine::RUNTIME, rows_, other.cols_, cols_),
+                threads,
+                [&](dispatch::Choice choice) { multiply(other, out, choice.impl, choice.threads); }
+            );
+            return;
+        default:
+            assert(supports(implementation) && "Impl not available for runtime extents");
+            return;
+        }
+    }
+
+    // out = this * other for complex elements, by the 3M or 4M method on
+    // the real register kernel; `threads` goes to each real product.
+    void multiply(
+        const Matrix& other,
+        Matrix& out,
+        complex_gemm::Method method = complex_gemm::Method::THREE_M,
+        std::size_t threads = 1
+    ) const requires complex_float<T> {
+        assert(cols_ == other.rows_ && "inner dimensions must agree");
+        assert(out.rows_ == rows_ && out.cols_ == other.cols_ && "output has the wrong shape");
+        complex_gemm::multiply(
+            matrix_.data(),       stride_,
+            other.matrix_.data(), other.stride_,
+            out.matrix_.data(),   out.stride_,
+            rows_, other.cols_, cols_,
+            method, threads
+        );
+    }
+
+    // out = this * other over the semiring S (semiring.hpp), e.g. one
+    // relaxation step of all-pairs shortest paths with semiring::MinPlus.
+    // Impl::NAIVE and Impl::TILED_REGISTERS; `threads` caps the latter.
+    template<typename S>
+    void multiply_over(
+        const Matrix& other,
+        Matrix& out,
+        Impl implementation = Impl::TILED_REGISTERS,
+        std::size_t threads = 1
+    ) const requires (!half_float<T> && !complex_float<T>) {
+        assert(cols_ == other.rows_ && "inner dimensions must agree");
+        assert(out.rows_ == rows_ && out.cols_ == other.cols_ && "output has the wrong shape");
+
+        if (implementation == Impl::NAIVE) {
+            for (std::size_t y = 0; y < rows_; ++y) {
+                for (std::size_t x = 0; x < other.cols_; ++x) {
+                    T sum = S::template zero<T>();
+                    for (std::size_t k = 0; k < cols_; ++k)
+                        sum = S::add(sum, S::mul(matrix_[getIndex(k,y)], other.matrix_[other.getIndex(x,k)]));
+                    out.set(x, y, sum);
+                }
+            }
+            return;
+        }
+        assert(implementation == Impl::TILED_REGISTERS && "Impl not available for semiring products");
+        kernels::multiply_semiring<S>(
+            matrix_.data(),       stride_,
+            other.matrix_.data(), other.stride_,
+            out.matrix_.data(),   out.stride_,
+            padded_rows_, other.stride_, stride_,
+            kernels::Extents{rows_, other.cols_, cols_},
+            threads
+        );
+    }
+
+    // out (rows x rows) = this * this^T in `triangle` only, zero elsewhere.
+    // Tiles on the other side of the diagonal are never computed.
+    void syrk(Matrix& out, Triangle triangle = Triangle::LOWER, std::size_t threads = 1) const {
+        assert(out.rows_ == rows_ && out.cols_ == rows_ && "output has the wrong shape");
+        const bool lower = triangle == Triangle::LOWER;
+        std::fill(out.matrix_.begin(), out.matrix_.end(), T{});
+        kernels::syrk_tiled_registers(matrix_.data(), stride_, out.matrix_.data(), out.stride_, padded_rows_, stride_, lower, threads);
+        kernels::clear_opposite_triangle(out.matrix_.data(), out.stride_, padded_rows_, lower);
+    }
+
+    bool operator==(const Matrix& other) const {
+        if (rows_ != other.rows_ || cols_ != other.cols_)
+            return false;
+        for (std::size_t y = 0; y < rows_; ++y)
+            for (std::size_t x = 0; x < cols_; ++x)
+                if (matrix_[getIndex(x,y)] != other.matrix_[other.getIndex(x,y)])
+                    return false;
+        return true;
+    }
+
+private:
+
+    template<typename Out>
+    void multiply_naive(const Matrix& other, Matrix<Out>& out) const {
+        using Acc = accumulator_t<T>;
+        for (std::size_t y = 0; y < rows_; ++y) {
+            for (std::size_t x = 0; x < other.cols_; ++x) {
+                Acc sum{};
+                for (std::size_t k = 0; k < cols_; ++k)
+                    sum += static_cast<Acc>(matrix_[getIndex(k,y)]) * static_cast<Acc>(other.matrix_[other.getIndex(x,k)]);
+                out.set(x, y, static_cast<Out>(sum));
+            }
+        }
+    }
+
+    template<typename Out>
+    void multiply_tiled_registers(const Matrix& other, Matrix<Out>& out, std::size_t threads) const {
+        std::fill(out.data(), out.data() + out.padded_rows() * out.stride(), Out{});
+        const kernels::Extents extents{rows_, other.cols_, cols_};
+        if constexpr (half_float<T>) {
+            kernels::multiply_mixed(
+                matrix_.data(),       stride_,
+                other.matrix_.data(), other.stride_,
+                out.data(),           out.stride(),
+                padded_rows_, other.stride_, stride_,
+                threads, extents
+            );
+        } else {
+            kernels::multiply_tiled_registers(
+                matrix_.data(),       stride_,
+                other.matrix_.data(), other.stride_,
+                out.data(),           out.stride(),
+                padded_rows_, other.stride_, stride_,
+                threads, extents
+            );
+        }
+    }
+};
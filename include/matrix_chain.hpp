@@ -0,0 +1,296 @@
+#pragma once
+
+#include "aligned_allocator.hpp"
+#include "kernels.hpp"
+#include "mat.hpp"
+#include "matrix.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cstddef>
+#include <limits>
+#include <string>
+#include <vector>
+
+// Lazy matrix chains.
+//
+// `A * B * C * D` on Matrix or SquareMatrix operands only records the
+// operands. When the chain is assigned or evaluate()d, the cheapest
+// parenthesization is chosen from the padded extents the register kernel
+// actually computes, intermediates are taken from a ChainWorkspace, and the
+// last product is written straight into the destination. Operands must
+// outlive the chain.
+
+// Reusable scratch for chain intermediates. Buffers are kept between
+// evaluations, so a chain evaluated repeatedly allocates only the first time.
+template<typename T>
+class ChainWorkspace {
+private:
+    using aligned_vector = std::vector<T, aligned_allocator<T, 64>>;
+
+    struct Buffer {
+        aligned_vector data;
+        bool in_use{};
+    };
+
+    std::vector<Buffer> buffers_;
+    std::size_t allocations_{};
+
+public:
+    // Smallest idle buffer holding `size` elements. Failing that, the largest
+    // idle one is regrown, and only if every buffer is busy is one added.
+    std::size_t acquire(std::size_t size) {
+        std::size_t fit = buffers_.size(), largest = buffers_.size();
+        for (std::size_t i{}; i < buffers_.size(); ++i) {
+            const std::size_t capacity = buffers_[i].data.size();
+            if (buffers_[i].in_use)
+                continue;
+            if (capacity >= size && (fit == buffers_.size() || capacity < buffers_[fit].data.size()))
+                fit = i;
+            if (largest == buffers_.size() || capacity > buffers_[largest].data.size())
+                largest = i;
+        }
+
+        std::size_t chosen = fit != buffers_.size() ? fit : largest;
+        if (chosen == buffers_.size()) {
+            chosen = buffers_.size();
+            buffers_.emplace_back();
+        }
+
+        auto& buffer = buffers_[chosen];
+        if (buffer.data.size() < size) {
+            buffer.data = aligned_vector(size);
+            ++allocations_;
+        }
+        buffer.in_use = true;
+        return chosen;
+    }
+
+    void release(std::size_t buffer) {
+        buffers_[buffer].in_use = false;
+    }
+
+    T* data(std::size_t buffer) {
+        return buffers_[buffer].data.data();
+    }
+
+    std::size_t buffers() const { return buffers_.size(); }
+    std::size_t allocations() const { return allocations_; }
+
+    void clear() {
+        assert(std::ranges::none_of(buffers_, &Buffer::in_use) && "clear() during evaluation");
+        buffers_.clear();
+    }
+};
+
+// Row-major operand over padded extents, as the kernels see it.
+template<typename T>
+struct ChainOperand {
+    const T* data;
+    std::size_t stride;
+    std::size_t rows;
+    std::size_t cols;
+
+    std::size_t padded_rows() const { return kernels::padded(rows); }
+};
+
+template<typename T, std::size_t K>
+class MatrixChain {
+private:
+    using Operand = ChainOperand<T>;
+
+    template<typename, std::size_t>
+    friend class MatrixChain;
+
+    using Table = std::array<std::array<std::size_t, K>, K>;
+
+    std::array<Operand, K> operands_;
+
+    struct Plan {
+        Table split;
+        double cost;
+    };
+
+    // Classic O(K^3) matrix-chain DP; extent i is the padded row count of
+    // operand i, extent K the padded column count of the last.
+    Plan plan() const {
+        std::array<double, K + 1> extent;
+        for (std::size_t i{}; i < K; ++i)
+            extent[i] = static_cast<double>(operands_[i].padded_rows());
+        extent[K] = static_cast<double>(operands_[K - 1].stride);
+
+        std::array<std::array<double, K>, K> cost{};
+        Table split{};
+        for (std::size_t length = 2; length <= K; ++length) {
+            for (std::size_t i{}; i + length <= K; ++i) {
+                const std::size_t j = i + length - 1;
+                cost[i][j] = std::numeric_limits<double>::infinity();
+                for (std::size_t s = i; s < j; ++s) {
+                    const double c = cost[i][s] + cost[s + 1][j] + extent[i] * extent[s + 1] * extent[j + 1];
+                    if (c < cost[i][j]) {
+                        cost[i][j] = c;
+                        split[i][j] = s;
+                    }
+                }
+            }
+        }
+        return {split, 2.0 * cost[0][K - 1]};
+    }
+
+    static constexpr std::size_t NO_BUFFER = std::numeric_limits<std::size_t>::max();
+
+    struct Result {
+        Operand operand;
+        std::size_t buffer;
+    };
+
+    // Product of operands [i, j]. Both halves are computed before the
+    // destination is claimed, and each inner node holds its inputs and its
+    // destination together, so the buffers alive at once are bounded by the
+    // height of the plan tree plus one: two for a left- or right-leaning
+    // order, four for a balanced eight-operand one. The root writes into
+    // `root`.
+    Result evaluate_range(
+        const Table& split,
+        std::size_t i, std::size_t j,
+        T* root,
+        ChainWorkspace<T>& workspace,
+        std::size_t threads
+    ) const {
+        if (i == j)
+            return {operands_[i], NO_BUFFER};
+
+        const std::size_t s = split[i][j];
+        const Result left = evaluate_range(split, i, s, nullptr, workspace, threads);
+        const Result right = evaluate_range(split, s + 1, j, nullptr, workspace, threads);
+
+        const Operand& a = left.operand;
+        const Operand& b = right.operand;
+        std::size_t buffer = NO_BUFFER;
+        T* c_ptr = root;
+        if (!c_ptr) {
+            buffer = workspace.acquire(a.padded_rows() * b.stride);
+            c_ptr = workspace.data(buffer);
+        }
+
+        std::fill(c_ptr, c_ptr + a.padded_rows() * b.stride, T{});
+        kernels::multiply_tiled_registers(
+            a.data, a.stride,
+            b.data, b.stride,
+            c_ptr,  b.stride,
+            a.padded_rows(), b.stride, a.stride,
+            threads
+        );
+
+        for (std::size_t consumed: {left.buffer, right.buffer})
+            if (consumed != NO_BUFFER)
+                workspace.release(consumed);
+
+        return {{c_ptr, b.stride, a.rows, b.cols}, buffer};
+    }
+
+    void evaluate_into(T* c_ptr, ChainWorkspace<T>& workspace, std::size_t threads) const {
+        static_assert(K >= 2, "a chain has at least two operands");
+        evaluate_range(plan().split, 0, K - 1, c_ptr, workspace, threads);
+    }
+
+    static ChainWorkspace<T>& default_workspace() {
+        thread_local ChainWorkspace<T> workspace;
+        return workspace;
+    }
+
+    std::string parenthesization(const Table& split, std::size_t i, std::size_t j) const {
+        if (i == j)
+            return "M" + std::to_string(i);
+        const std::size_t s = split[i][j];
+        return "(" + parenthesization(split, i, s) + " " + parenthesization(split, s + 1, j) + ")";
+    }
+
+public:
+    // A single operand is a leaf; evaluation needs K >= 2.
+    explicit MatrixChain(const std::array<Operand, K>& operands)
+        : operands_(operands) {
+        for (std::size_t i = 1; i < K; ++i)
+            assert(operands_[i - 1].cols == operands_[i].rows && "inner dimensions must agree");
+    }
+
+    template<std::size_t L>
+    MatrixChain<T, K + L> concat(const MatrixChain<T, L>& other) const {
+        std::array<Operand, K + L> operands;
+        std::ranges::copy(operands_, operands.begin());
+        std::ranges::copy(other.operands_, operands.begin() + K);
+        return MatrixChain<T, K + L>(operands);
+    }
+
+    std::size_t rows() const { return operands_.front().rows; }
+    std::size_t cols() const { return operands_.back().cols; }
+
+    // Operations the padded kernels perform under the chosen order.
+    double ops() const {
+        return plan().cost;
+    }
+
+    // Chosen order, operands named M0..M(K-1), e.g. "((M0 M1) M2)".
+    std::string order() const {
+        return parenthesization(plan().split, 0, K - 1);
+    }
+
+    // out = the chain's product; out must not be one of the operands.
+    void evaluate(Matrix<T>& out, ChainWorkspace<T>& workspace, std::size_t threads = 1) const {
+        assert(out.rows() == rows() && out.cols() == cols() && "output has the wrong shape");
+        evaluate_into(out.data(), workspace, threads);
+    }
+
+    void evaluate(Matrix<T>& out, std::size_t threads = 1) const {
+        evaluate(out, default_workspace(), threads);
+    }
+
+    // The result's transposed copy is not refreshed, as with multiply().
+    template<std::size_t N>
+    void evaluate(SquareMatrix<T, N>& out, ChainWorkspace<T>& workspace, std::size_t threads = 1) const {
+        assert(rows() == N && cols() == N && "output has the wrong shape");
+        evaluate_into(out.data(), workspace, threads);
+    }
+
+    template<std::size_t N>
+    void evaluate(SquareMatrix<T, N>& out, std::size_t threads = 1) const {
+        evaluate(out, default_workspace(), threads);
+    }
+
+    operator Matrix<T>() const {
+        Matrix<T> out(rows(), cols());
+        evaluate(out);
+        return out;
+    }
+
+    template<std::size_t N>
+    operator SquareMatrix<T, N>() const {
+        SquareMatrix<T, N> out{};
+        evaluate(out);
+        return out;
+    }
+};
+
+template<typename T>
+MatrixChain<T, 1> as_chain(const Matrix<T>& m) {
+    return MatrixChain<T, 1>({ChainOperand<T>{m.data(), m.stride(), m.rows(), m.cols()}});
+}
+
+template<typename T, std::size_t N>
+MatrixChain<T, 1> as_chain(const SquareMatrix<T, N>& m) {
+    return MatrixChain<T, 1>({ChainOperand<T>{m.data(), SquareMatrix<T, N>::stride(), N, N}});
+}
+
+template<typename T, std::size_t K>
+const MatrixChain<T, K>& as_chain(const MatrixChain<T, K>& chain) {
+    return chain;
+}
+
+template<typename M>
+concept ChainArgument = requires(const M& m) { as_chain(m); };
+
+template<ChainArgument L, ChainArgument R>
+auto operator*(const L& left, const R& right) {
+    return as_chain(left).concat(as_chain(right));
+}
@@ -0,0 +1,210 @@
+#pragma once
+
+// Counter-based random integers for make_random: Philox4x32-10 (Salmon et
+// al., "Parallel Random Numbers: As Easy as 1, 2, 3", SC'11). Element
+// (row, col) of a matrix drawn with seed s is lane col % 4 of the block for
+// counter (col / 4, row) under key s. Every element is a pure function of
+// its coordinates, so rows can be split over any number of threads, each
+// buffer is written in its own storage order, and a transposed copy is
+// drawn directly rather than transposed. LANES counters go through the
+// rounds together, on AVX2 as packed 32 x 32 -> 64-bit multiplies.
+
+#include <array>
+#include <climits>
+#include <cstddef>
+#include <cstdint>
+
+#include <immintrin.h>
+
+namespace philox {
+
+inline constexpr std::size_t LANES = 16;
+
+inline constexpr std::uint32_t MULTIPLIER_0 = 0xD2511F53;
+inline constexpr std::uint32_t MULTIPLIER_1 = 0xCD9E8D57;
+inline constexpr std::uint32_t WEYL_0 = 0x9E3779B9;
+inline constexpr std::uint32_t WEYL_1 = 0xBB67AE85;
+inline constexpr int ROUNDS = 10;
+
+using Block = std::array<std::uint32_t, 4>;
+
+// One block, the reference the batched generator is tested against.
+constexpr Block generate(Block counter, std::uint64_t key) {
+    std::uint32_t k0 = static_cast<std::uint32_t>(key);
+    std::uint32_t k1 = static_cast<std::uint32_t>(key >> 32);
+    for (int round{}; round < ROUNDS; ++round) {
+        const std::uint64_t p0 = std::uint64_t{MULTIPLIER_0} * counter[0];
+        const std::uint64_t p1 = std::uint64_t{MULTIPLIER_1} * counter[2];
+        counter = {
+            static_cast<std::uint32_t>(p1 >> 32) ^ counter[1] ^ k0,
+            static_cast<std::uint32_t>(p1),
+            static_cast<std::uint32_t>(p0 >> 32) ^ counter[3] ^ k1,
+            static_cast<std::uint32_t>(p0),
+        };
+        k0 += WEYL_0;
+        k1 += WEYL_1;
+    }
+    return counter;
+}
+
+// out[l][i] = lane l of the block for counter (col_blocks[i], rows[i]).
+inline void generate(
+    const std::uint64_t (&col_blocks)[LANES],
+    const std::uint64_t (&rows)[LANES],
+    std::uint64_t key,
+    std::uint32_t (&out)[4][LANES]
+) {
+    std::uint32_t c0[LANES], c1[LANES], c2[LANES], c3[LANES];
+    for (std::size_t i{}; i < LANES; ++i) {
+        c0[i] = static_cast<std::uint32_t>(col_blocks[i]);
+        c1[i] = static_cast<std::uint32_t>(rows[i]);
+        c2[i] = static_cast<std::uint32_t>(col_blocks[i] >> 32);
+        c3[i] = static_cast<std::uint32_t>(rows[i] >> 32);
+    }
+
+    std::uint32_t k0 = static_cast<std::uint32_t>(key);
+    std::uint32_t k1 = static_cast<std::uint32_t>(key >> 32);
+#if defined(__AVX2__)
+    // vpmuludq multiplies the even 32-bit lanes; the odd ones go through a
+    // second multiply after a 64-bit shift, and blends reassemble hi / lo.
+    auto load = [](const std::uint32_t* p) { return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p)); };
+    auto store = [](std::uint32_t* p, __m256i v) { _mm256_storeu_si256(reinterpret_cast<__m256i*>(p), v); };
+    auto mul_hi_lo = [](__m256i x, __m256i multiplier, __m256i& hi, __m256i& lo) {
+        const __m256i even = _mm256_mul_epu32(x, multiplier);
+        const __m256i odd = _mm256_mul_epu32(_mm256_srli_epi64(x, 32), multiplier);
+        lo = _mm256_blend_epi32(even, _mm256_slli_epi64(odd, 32), 0xAA);
+        hi = _mm256_blend_epi32(_mm256_srli_epi64(even, 32), odd, 0xAA);
+    };
+
+    // Two independent sets of eight lanes hide the multiply latency.
+    static_assert(LANES == 16);
+    __m256i v0[2], v1[2], v2[2], v3[2];
+    for (std::size_t j{}; j < 2; ++j) {
+        v0[j] = load(c0 + 8 * j);
+        v1[j] = load(c1 + 8 * j);
+        v2[j] = load(c2 + 8 * j);
+        v3[j] = load(c3 + 8 * j);
+    }
+    const __m256i m0 = _mm256_set1_epi32(static_cast<int>(MULTIPLIER_0));
+    const __m256i m1 = _mm256_set1_epi32(static_cast<int>(MULTIPLIER_1));
+    for (int round{}; round < ROUNDS; ++round) {
+        const __m256i key0 = _mm256_set1_epi32(static_cast<int>(k0));
+        const __m256i key1 = _mm256_set1_epi32(static_cast<int>(k1));
+        for (std::size_t j{}; j < 2; ++j) {
+            __m256i hi0, lo0, hi1, lo1;
+            mul_hi_lo(v0[j], m0, hi0, lo0);
+            mul_hi_lo(v2[j], m1, hi1, lo1);
+            v0[j] = _mm256_xor_si256(_mm256_xor_si256(hi1, v1[j]), key0);
+            v2[j] = _mm256_xor_si256(_mm256_xor_si256(hi0, v3[j]), key1);
+            v1[j] = lo1;
+            v3[j] = lo0;
+        }
+        k0 += WEYL_0;
+        k1 += WEYL_1;
+    }
+    for (std::size_t j{}; j < 2; ++j) {
+        store(out[0] + 8 * j, v0[j]);
+        store(out[1] + 8 * j, v1[j]);
+        store(out[2] + 8 * j, v2[j]);
+        store(out[3] + 8 * j, v3[j]);
+    }
+#else
+    for (int round{}; round < ROUNDS; ++round) {
+        for (std::size_t i{}; i < LANES; ++i) {
+            const std::uint64_t p0 = std::uint64_t{MULTIPLIER_0} * c0[i];
+            const std::uint64_t p1 = std::uint64_t{MULTIPLIER_1} * c2[i];
+            const std::uint32_t next0 = static_cast<std::uint32_t>(p1 >> 32) ^ c1[i] ^ k0;
+            const std::uint32_t next2 = static_cast<std::uint32_t>(p0 >> 32) ^ c3[i] ^ k1;
+            c1[i] = static_cast<std::uint32_t>(p1);
+            c3[i] = static_cast<std::uint32_t>(p0);
+            c0[i] = next0;
+            c2[i] = next2;
+        }
+        k0 += WEYL_0;
+        k1 += WEYL_1;
+    }
+
+    for (std::size_t i{}; i < LANES; ++i) {
+        out[0][i] = c0[i];
+        out[1][i] = c1[i];
+        out[2][i] = c2[i];
+        out[3][i] = c3[i];
+    }
+#endif
+}
+
+// Integers uniform in [lower, upper] by multiply-shift; the bias is below
+// (upper - lower + 1) / 2^32.
+struct Range {
+    std::int64_t lower;
+    std::uint64_t span;  // upper - lower + 1, at most 2^32
+
+    Range(std::int64_t lower_bound, std::int64_t upper_bound)
+        : lower(lower_bound)
+        , span(static_cast<std::uint64_t>(upper_bound - lower_bound) + 1) {}
+
+    std::uint32_t offset(std::uint32_t bits) const {
+        return static_cast<std::uint32_t>(bits * span >> 32);
+    }
+
+    // dst[i] = lower + offset(bits[i]), in 32-bit arithmetic when the
+    // bounds allow it so the conversion vectorizes.
+    template<typename T>
+    void map(const std::uint32_t* bits, T* dst, std::size_t count) const {
+        if (span < (std::uint64_t{1} << 32) && lower >= INT32_MIN && lower + static_cast<std::int64_t>(span) - 1 <= INT32_MAX) {
+            const auto base = static_cast<std::int32_t>(lower);
+            const auto span32 = static_cast<std::uint32_t>(span);
+            for (std::size_t i{}; i < count; ++i) {
+                const auto scaled = static_cast<std::uint32_t>(std::uint64_t{bits[i]} * span32 >> 32);
+                dst[i] = static_cast<T>(base + static_cast<std::int32_t>(scaled));
+            }
+        } else {
+            for (std::size_t i{}; i < count; ++i)
+                dst[i] = static_cast<T>(lower + static_cast<std::int64_t>(offset(bits[i])));
+        }
+    }
+};
+
+// dst[c] = element (row, col + c) for c < count; col is a multiple of 4.
+template<typename T>
+void fill_row(T* dst, std::uint64_t row, std::size_t col, std::size_t count, std::uint64_t seed, const Range& range) {
+    std::uint64_t col_blocks[LANES], rows[LANES];
+    std::uint32_t out[4][LANES];
+    for (std::size_t i{}; i < LANES; ++i)
+        rows[i] = row;
+
+    for (std::size_t done{}; done < count; done += 4 * LANES) {
+        for (std::size_t i{}; i < LANES; ++i)
+            col_blocks[i] = (col + done) / 4 + i;
+        generate(col_blocks, rows, seed, out);
+
+        std::uint32_t bits[4 * LANES];
+        for (std::size_t i{}; i < LANES; ++i)
+            for (std::size_t l{}; l < 4; ++l)
+                bits[4 * i + l] = out[l][i];
+        range.map(bits, dst + done, count - done < 4 * LANES ? count - done : 4 * LANES);
+    }
+}
+
+// Columns col .. col + 3 of rows row .. row + count - 1, written as four
+// rows: dst[l * dst_stride + r] = element (row + r, col + l). col is a
+// multiple of 4.
+template<typename T>
+void fill_transposed(T* dst, std::size_t dst_stride, std::size_t col, std::uint64_t row, std::size_t count, std::uint64_t seed, const Range& range) {
+    std::uint64_t col_blocks[LANES], rows[LANES];
+    std::uint32_t out[4][LANES];
+    for (std::size_t i{}; i < LANES; ++i)
+        col_blocks[i] = col / 4;
+
+    for (std::size_t done{}; done < count; done += LANES) {
+        for (std::size_t i{}; i < LANES; ++i)
+            rows[i] = row + done + i;
+        generate(col_blocks, rows, seed, out);
+
+        const std::size_t limit = count - done < LANES ? count - done : LANES;
+        for (std::size_t l{}; l < 4; ++l)
+            range.map(out[l], dst + l * dst_stride + done, limit);
+    }
+}
+
+} // namespace philox
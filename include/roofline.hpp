@@ -0,0 +1,187 @@
+#pragma once
+
+// Host roofline: peak SIMD multiply-add throughput, sustained read bandwidth
+// per cache level and a per-Impl traffic model to place each kernel on it.
+
+#include "aligned_allocator.hpp"
+#include "mat.hpp"
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <string_view>
+#include <vector>
+
+#include <unistd.h>
+
+namespace roofline {
+
+struct MemoryLevel {
+    std::string_view name;
+    std::size_t bytes;      // capacity of the level (0 = unbounded)
+    double gbs;             // sustained read bandwidth, GB/s
+};
+
+struct MachinePeaks {
+    double gops;            // 2 ops per multiply-add lane, matches the GOps counter
+    std::array<MemoryLevel, 4> levels;
+
+    // Bandwidth of the smallest level that holds `working_set` bytes.
+    const MemoryLevel& level_for(std::size_t working_set) const {
+        for (const auto& level: levels)
+            if (level.bytes == 0 || working_set <= level.bytes)
+                return level;
+        return levels.back();
+    }
+
+    double ridge(const MemoryLevel& level) const {
+        return gops / level.gbs;
+    }
+};
+
+namespace detail {
+
+template<typename Fn>
+double seconds(Fn&& fn) {
+    const auto start = std::chrono::steady_clock::now();
+    fn();
+    const auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double>(end - start).count();
+}
+
+inline std::size_t cache_size(int name, std::size_t fallback) {
+    const long bytes = sysconf(name);
+    return bytes > 0 ? static_cast<std::size_t>(bytes) : fallback;
+}
+
+} // namespace detail
+
+// Independent accumulator chains keep every FMA/mul+add port busy.
+template<typename T>
+double measure_peak_gops() {
+    using simd_t = stdx::native_simd<T>;
+    static constexpr std::size_t CHAINS = 12;
+    static constexpr std::size_t ITERATIONS = 1 << 22;
+
+    // volatile so the compiler cannot fold the multiply-add away
+    volatile T scale = std::is_floating_point_v<T> ? T(0.999999) : T(1);
+    volatile T shift = T(1);
+    const simd_t x(static_cast<T>(scale));
+    const simd_t y(static_cast<T>(shift));
+
+    double best = 0.0;
+    for (int rep{}; rep < 3; ++rep) {
+        std::array<simd_t, CHAINS> acc;
+        acc.fill(simd_t(T(1)));
+
+        const double elapsed = detail::seconds([&] {
+            for (std::size_t i{}; i < ITERATIONS; ++i) {
+                for (auto& a: acc)
+                    a = a * x + y;
+            }
+        });
+
+        simd_t sum{};
+        for (const auto& a: acc)
+            sum += a;
+        volatile T sink = stdx::reduce(sum);
+        (void)sink;
+
+        const double ops = 2.0 * CHAINS * simd_t::size() * ITERATIONS;
+        best = std::max(best, ops / elapsed * 1e-9);
+    }
+    return best;
+}
+
+// Repeated SIMD read-reduce over a buffer of `bytes`.
+template<typename T>
+double measure_read_bandwidth(std::size_t bytes) {
+    using simd_t = stdx::native_simd<T>;
+    static constexpr std::size_t MIN_TRAFFIC = std::size_t{1} << 31;
+
+    const std::size_t count = std::max(bytes / sizeof(T) / simd_t::size(), std::size_t{4})
+                            * simd_t::size();
+    std::vector<T, aligned_allocator<T, 64>> buffer(count, T(1));
+    const std::size_t passes = std::max(MIN_TRAFFIC / (count * sizeof(T)), std::size_t{1});
+
+    double best = 0.0;
+    for (int rep{}; rep < 3; ++rep) {
+        std::array<simd_t, 4> acc{};
+        const double elapsed = detail::seconds([&] {
+            for (std::size_t p{}; p < passes; ++p) {
+                for (std::size_t i{}; i < count; i += 4 * simd_t::size()) {
+                    for (std::size_t c{}; c < acc.size(); ++c) {
+                        simd_t v;
+                        v.copy_from(buffer.data() + i + c * simd_t::size(), stdx::vector_aligned);
+                        acc[c] += v;
+                    }
+                }
+            }
+        });
+
+        volatile T sink = stdx::reduce(acc[0] + acc[1] + acc[2] + acc[3]);
+        (void)sink;
+
+        const double traffic = static_cast<double>(passes * count * sizeof(T));
+        best = std::max(best, traffic / elapsed * 1e-9);
+    }
+    return best;
+}
+
+template<typename T>
+MachinePeaks measure_machine() {
+    const std::size_t l1 = detail::cache_size(_SC_LEVEL1_DCACHE_SIZE, 32 << 10);
+    const std::size_t l2 = detail::cache_size(_SC_LEVEL2_CACHE_SIZE, 1 << 20);
+    const std::size_t l3 = detail::cache_size(_SC_LEVEL3_CACHE_SIZE, 16 << 20);
+
+    // Probe at half capacity so the buffer stays resident; DRAM well past L3.
+    return MachinePeaks{
+        .gops = measure_peak_gops<T>(),
+        .levels = {{
+            {"L1",   l1, measure_read_bandwidth<T>(l1 / 2)},
+            {"L2",   l2, measure_read_bandwidth<T>(l2 / 2)},
+            {"L3",   l3, measure_read_bandwidth<T>(l3 / 2)},
+            {"DRAM", 0,  measure_read_bandwidth<T>(std::max(4 * l3, std::size_t{256} << 20))},
+        }}
+    };
+}
+
+// Estimated bytes moved between the level holding the operands and the core.
+// Each Impl streams whatever its loop nest fails to reuse: the scalar and
+// transposed kernels re-read B once per row of A, the tiled kernels re-read
+// B and C once per k-tile. Once the operands fit in `cache_bytes` only the
+// compulsory 3N^2 traffic remains.
+template<typename T>
+double estimated_bytes(Impl implementation, std::size_t N, std::size_t cache_bytes) {
+    static constexpr double LINE_ELEMENTS = 64.0 / sizeof(T);
+
+    const double n  = static_cast<double>(N);
+    const double n2 = n * n;
+    const double n3 = n2 * n;
+    const double compulsory = 3.0 * n2;
+
+    if (3 * N * N * sizeof(T) <= cache_bytes)
+        return compulsory * sizeof(T);
+
+    double elements = compulsory;
+    switch (implementation) {
+    case Impl::NAIVE:           elements = 2.0 * n2 + n3 * LINE_ELEMENTS; break;
+    case Impl::TRANSPOSED:
+    case Impl::TRANSPOSED_SIMD: elements = 2.0 * n2 + n3; break;
+    case Impl::TILED:
+    case Impl::TILED_SIMD:
+    case Impl::TILED_PREFETCH:  elements = n2 + 3.0 * n3 / 32.0; break;
+    case Impl::TILED_REGISTERS: elements = n2 + 3.0 * n3 / 48.0; break;
+    default: break;
+    }
+    return elements * sizeof(T);
+}
+
+template<typename T>
+double arithmetic_intensity(Impl implementation, std::size_t N, std::size_t cache_bytes) {
+    const double ops = 2.0 * static_cast<double>(N) * N * N;
+    return ops / estimated_bytes<T>(implementation, N, cache_bytes);
+}
+
+} // namespace roofline
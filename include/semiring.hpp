@@ -0,0 +1,65 @@
+#pragma once
+
+// Semirings for the register-blocked kernel. A policy supplies zero<T>(),
+// the identity of add and the annihilator of mul, and add / mul written
+// once for scalars and stdx::simd values alike: on vectors, min / max /
+// | / & are single instructions (vminps, vpmaxsd, vpor, vpand, ...), so
+// graph products run at the speed of the ordinary one.
+//
+// zero<T>() also fills the depth padding of A packs, where a plain 0 would
+// be a real edge for the tropical semirings.
+
+#include <algorithm>
+#include <concepts>
+#include <limits>
+
+namespace semiring {
+
+// The ordinary (+, *) product.
+struct PlusTimes {
+    template<typename T>
+    static constexpr T zero() { return T{}; }
+
+    static constexpr auto add(const auto& a, const auto& b) { return a + b; }
+    static constexpr auto mul(const auto& a, const auto& b) { return a * b; }
+};
+
+// Shortest paths. "No path" is +infinity, or max() / 2 for integers so that
+// adding two of them cannot overflow.
+struct MinPlus {
+    template<typename T>
+    static constexpr T zero() {
+        if constexpr (std::numeric_limits<T>::has_infinity)
+            return std::numeric_limits<T>::infinity();
+        else
+            return std::numeric_limits<T>::max() / 2;
+    }
+
+    static constexpr auto add(const auto& a, const auto& b) { using std::min; return min(a, b); }
+    static constexpr auto mul(const auto& a, const auto& b) { return a + b; }
+};
+
+// Longest (critical) paths, the mirror image of MinPlus.
+struct MaxPlus {
+    template<typename T>
+    static constexpr T zero() {
+        if constexpr (std::numeric_limits<T>::has_infinity)
+            return -std::numeric_limits<T>::infinity();
+        else
+            return std::numeric_limits<T>::lowest() / 2;
+    }
+
+    static constexpr auto add(const auto& a, const auto& b) { using std::max; return max(a, b); }
+    static constexpr auto mul(const auto& a, const auto& b) { return a + b; }
+};
+
+// Reachability over 0 / 1 integers.
+struct Boolean {
+    template<std::integral T>
+    static constexpr T zero() { return T{}; }
+
+    static constexpr auto add(const auto& a, const auto& b) { return a | b; }
+    static constexpr auto mul(const auto& a, const auto& b) { return a & b; }
+};
+
+} // namespace semiring
@@ -0,0 +1,183 @@
+#pragma once
+
+// summa::Transport between processes on one host over a POSIX shared-memory
+// segment. Every (rank, tag) pair owns a mailbox: the root copies its bytes
+// in and bumps `published`; receivers wait for it, copy out and bump
+// `acks`. The root only overwrites a mailbox once every receiver of the
+// previous message has acknowledged it.
+
+#include "summa.hpp"
+
+#include <atomic>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <new>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <thread>
+#include <vector>
+
+#include <fcntl.h>
+#include <immintrin.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace summa {
+
+class ShmTransport final : public Transport {
+private:
+    static constexpr std::uint64_t READY = 0x53554d4d41ull;  // "SUMMA"
+
+    struct alignas(64) Header {
+        std::atomic<std::uint64_t> ready;
+        std::atomic<std::uint64_t> attached;
+        std::atomic<std::uint64_t> barrier_arrived;
+        std::atomic<std::uint64_t> barrier_generation;
+    };
+
+    struct alignas(64) Mailbox {
+        std::atomic<std::uint64_t> published;
+        std::atomic<std::uint64_t> acks;
+    };
+
+    std::string name_;
+    std::size_t rank_;
+    std::size_t size_;
+    std::size_t slot_bytes_;
+    std::size_t segment_bytes_;
+    void* segment_;
+
+    std::vector<std::uint64_t> received_;   // per (root, tag): messages consumed
+    std::vector<std::uint64_t> owed_acks_;  // per tag: acks due for our own messages
+
+    static void check(bool ok, const char* what) {
+        if (!ok)
+            throw std::system_error(errno, std::generic_category(), what);
+    }
+
+    static void wait_until(auto&& ready) {
+        for (std::size_t spins{}; !ready(); ++spins) {
+            if (spins < 64)
+                _mm_pause();
+            else
+                std::this_thread::yield();
+        }
+    }
+
+    std::size_t slot_stride() const {
+        return sizeof(Mailbox) + (slot_bytes_ + 63) / 64 * 64;
+    }
+
+    Header& header() const {
+        return *static_cast<Header*>(segment_);
+    }
+
+    Mailbox& mailbox(std::size_t rank, std::size_t tag) const {
+        auto* base = static_cast<std::byte*>(segment_) + sizeof(Header);
+        return *reinterpret_cast<Mailbox*>(base + (rank * TAG_COUNT + tag) * slot_stride());
+    }
+
+    std::byte* payload(std::size_t rank, std::size_t tag) const {
+        return reinterpret_cast<std::byte*>(&mailbox(rank, tag)) + sizeof(Mailbox);
+    }
+
+public:
+    // Rank 0 creates the segment `name` (e.g. "/gemm-summa-1234"); the others
+    // attach once it is initialised. slot_bytes bounds a single message.
+    ShmTransport(std::string name, std::size_t rank, std::size_t size, std::size_t slot_bytes)
+        : name_(std::move(name))
+        , rank_(rank)
+        , size_(size)
+        , slot_bytes_(slot_bytes)
+        , received_(size * TAG_COUNT)
+        , owed_acks_(TAG_COUNT) {
+        segment_bytes_ = sizeof(Header) + size_ * TAG_COUNT * slot_stride();
+
+        int fd;
+        if (rank_ == 0) {
+            fd = shm_open(name_.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+            check(fd >= 0, "shm_open");
+            check(ftruncate(fd, static_cast<off_t>(segment_bytes_)) == 0, "ftruncate");
+        } else {
+            wait_until([&] { return (fd = shm_open(name_.c_str(), O_RDWR, 0600)) >= 0; });
+            struct stat info{};
+            wait_until([&] { return fstat(fd, &info) == 0 && static_cast<std::size_t>(info.st_size) >= segment_bytes_; });
+        }
+
+        segment_ = mmap(nullptr, segment_bytes_, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        close(fd);
+        check(segment_ != MAP_FAILED, "mmap");
+
+        if (rank_ == 0) {
+            new (segment_) Header{};
+            for (std::size_t r{}; r < size_; ++r)
+                for (std::size_t tag{}; tag < TAG_COUNT; ++tag)
+                    new (&mailbox(r, tag)) Mailbox{};
+            header().ready.store(READY, std::memory_order_release);
+        } else {
+            wait_until([&] { return header().ready.load(std::memory_order_acquire) == READY; });
+        }
+
+        // Once everyone is mapped the name is no longer needed, so a crash
+        // later cannot leak it.
+        if (header().attached.fetch_add(1, std::memory_order_acq_rel) + 1 == size_)
+            shm_unlink(name_.c_str());
+        barrier();
+    }
+
+    ShmTransport(const ShmTransport&) = delete;
+    ShmTransport& operator=(const ShmTransport&) = delete;
+
+    ~ShmTransport() override {
+        munmap(segment_, segment_bytes_);
+    }
+
+    std::size_t rank() const override { return rank_; }
+    std::size_t size() const override { return size_; }
+
+    void broadcast(
+        std::span<std::byte> buffer,
+        std::size_t root,
+        std::span<const std::size_t> group,
+        std::size_t tag
+    ) override {
+        if (group.size() <= 1)
+            return;
+        if (buffer.size() > slot_bytes_)
+            throw std::length_error("summa::ShmTransport: message exceeds slot size");
+
+        Mailbox& box = mailbox(root, tag);
+        if (rank_ == root) {
+            wait_until([&] { return box.acks.load(std::memory_order_acquire) >= owed_acks_[tag]; });
+            std::memcpy(payload(root, tag), buffer.data(), buffer.size());
+            owed_acks_[tag] += group.size() - 1;
+            box.published.fetch_add(1, std::memory_order_release);
+            return;
+        }
+
+        std::uint64_t& received = received_[root * TAG_COUNT + tag];
+        wait_until([&] { return box.published.load(std::memory_order_acquire) > received; });
+        std::memcpy(buffer.data(), payload(root, tag), buffer.size());
+        ++received;
+        box.acks.fetch_add(1, std::memory_order_release);
+    }
+
+    // Sense-reversing barrier over all ranks.
+    void barrier() override {
+        Header& h = header();
+        const std::uint64_t generation = h.barrier_generation.load(std::memory_order_acquire);
+        if (h.barrier_arrived.fetch_add(1, std::memory_order_acq_rel) + 1 == size_) {
+            h.barrier_arrived.store(0, std::memory_order_relaxed);
+            h.barrier_generation.fetch_add(1, std::memory_order_release);
+            return;
+        }
+        wait_until([&] { return h.barrier_generation.load(std::memory_order_acquire) != generation; });
+    }
+};
+
+} // namespace summa
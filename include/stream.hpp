@@ -0,0 +1,101 @@
+#pragma once
+
+// Streaming GEMM for a fixed B: C rows = A rows * B, with A arriving a few
+// rows at a time. B is packed once, when the RowBlockGemm is built, into
+// contiguous 48 x 48 tiles the microkernel reads in place; each push()
+// gathers its rows of A into packs, runs the register kernel against the
+// retained tiles and writes the matching rows of C straight away. The
+// microkernel stops at the last pushed row (rounded up to 6), so a push
+// costs in proportion to its height, not to a 48-row tile or the whole A.
+
+#include "aligned_allocator.hpp"
+#include "kernels.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <span>
+#include <vector>
+
+namespace stream {
+
+template<typename T>
+class RowBlockGemm {
+private:
+    static constexpr std::size_t TILE_SIZE = kernels::REGISTER_TILE;
+    using aligned_vector = std::vector<T, aligned_allocator<T, 64>>;
+
+    std::size_t depth_;
+    std::size_t cols_;
+    std::size_t col_tiles_;
+    std::size_t depth_tiles_;
+    aligned_vector b_tiles_;  // tile (k, j) at (k * col_tiles_ + j) * 48^2
+
+    const T* b_tile(std::size_t k, std::size_t j) const {
+        return b_tiles_.data() + (k * col_tiles_ + j) * TILE_SIZE * TILE_SIZE;
+    }
+
+    // pack[r][c] = a[row + r][k + c] inside the block, zero outside.
+    void gather(const T* a, std::size_t rows, std::size_t row, std::size_t k, kernels::Pack<T, TILE_SIZE>& pack) const {
+        GEMM_TRACE_SPAN(PACK);
+        const std::size_t row_limit = std::min(TILE_SIZE, rows - row);
+        const std::size_t col_limit = std::min(TILE_SIZE, depth_ - k);
+        for (std::size_t r{}; r < row_limit; ++r) {
+            T* dst = pack.data() + r * TILE_SIZE;
+            std::copy_n(a + (row + r) * depth_ + k, col_limit, dst);
+            std::fill(dst + col_limit, dst + TILE_SIZE, T{});
+        }
+        std::fill(pack.data() + row_limit * TILE_SIZE, pack.data() + pack.size(), T{});
+    }
+
+public:
+    // B is depth x cols, row-major with `b_stride` elements per row.
+    RowBlockGemm(const T* b, std::size_t b_stride, std::size_t depth, std::size_t cols)
+        : depth_(depth)
+        , cols_(cols)
+        , col_tiles_(kernels::padded(cols) / TILE_SIZE)
+        , depth_tiles_(kernels::padded(depth) / TILE_SIZE)
+        , b_tiles_(depth_tiles_ * col_tiles_ * TILE_SIZE * TILE_SIZE) {
+        for (std::size_t k{}; k < depth; ++k) {
+            T* row = b_tiles_.data() + (k / TILE_SIZE * col_tiles_) * TILE_SIZE * TILE_SIZE + k % TILE_SIZE * TILE_SIZE;
+            for (std::size_t j{}; j < cols; ++j)
+                row[j / TILE_SIZE * TILE_SIZE * TILE_SIZE + j % TILE_SIZE] = b[k * b_stride + j];
+        }
+    }
+
+    std::size_t depth() const { return depth_; }
+    std::size_t cols() const { return cols_; }
+
+    // c = a * B for a block of rows: a is rows x depth and c rows x cols,
+    // both dense row-major. Any height works; the 48 x 48 output tiles of
+    // the block are spread over `threads` workers.
+    void push(std::span<const T> a, std::span<T> c, std::size_t threads = 1) const {
+        GEMM_TRACE_SPAN(MULTIPLY);
+        assert(depth_ > 0 && a.size() % depth_ == 0 && "a must hold whole rows");
+        const std::size_t rows = a.size() / depth_;
+        assert(c.size() == rows * cols_ && "c has the wrong size");
+
+        const std::size_t row_tiles = kernels::padded(rows) / TILE_SIZE;
+        kernels::for_each_row_tile(row_tiles * col_tiles_, threads, [&](std::size_t task) {
+            GEMM_TRACE_SPAN(TILE_ROW);
+            const std::size_t row = task / col_tiles_ * TILE_SIZE;
+            const std::size_t j = task % col_tiles_;
+            const std::size_t tile_rows = std::min(TILE_SIZE, rows - row);
+            const std::size_t tile_cols = std::min(TILE_SIZE, cols_ - j * TILE_SIZE);
+
+            alignas(64) kernels::Pack<T, TILE_SIZE> a_pack;
+            alignas(64) kernels::Pack<T, TILE_SIZE> c_tile{};
+            for (std::size_t k{}; k < depth_tiles_; ++k) {
+                GEMM_TRACE_SPAN(TILE_PANEL);
+                gather(a.data(), rows, row, k * TILE_SIZE, a_pack);
+                const std::size_t tile_depth = std::min(TILE_SIZE, depth_ - k * TILE_SIZE);
+                kernels::multiply_tile<T, TILE_SIZE>(a_pack.data(), b_tile(k, j), c_tile.data(), TILE_SIZE, 0, 0, tile_rows, tile_cols, tile_depth);
+            }
+
+            for (std::size_t r{}; r < tile_rows; ++r)
+                std::copy_n(c_tile.data() + r * TILE_SIZE, tile_cols, c.data() + (row + r) * cols_ + j * TILE_SIZE);
+        });
+    }
+};
+
+} // namespace stream
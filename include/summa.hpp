@@ -0,0 +1,226 @@
+#pragma once
+
+// SUMMA: C = A * B over a rows x cols grid of ranks, each owning one block
+// of A, B and C. The shared dimension is cut into panels; per panel the rank
+// column owning that slice of A broadcasts it along every grid row, the
+// rank row owning that slice of B broadcasts it down every grid column, and
+// each rank accumulates its block with the register-blocked engine.
+// Communication goes through a Transport, so the same code runs over
+// shared memory today and a network later.
+
+#include "kernels.hpp"
+#include "matrix.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <chrono>
+#include <cstddef>
+#include <span>
+#include <vector>
+
+namespace summa {
+
+class Transport {
+public:
+    virtual ~Transport() = default;
+
+    virtual std::size_t rank() const = 0;
+    virtual std::size_t size() const = 0;
+
+    // Called by every rank in `group` (world ranks, root included). On return
+    // `buffer` holds the root's bytes everywhere. A (root, tag) pair must
+    // always address the same group.
+    virtual void broadcast(
+        std::span<std::byte> buffer,
+        std::size_t root,
+        std::span<const std::size_t> group,
+        std::size_t tag
+    ) = 0;
+
+    virtual void barrier() = 0;
+};
+
+inline constexpr std::size_t ROW_TAG = 0;     // A panels, along grid rows
+inline constexpr std::size_t COLUMN_TAG = 1;  // B panels, down grid columns
+inline constexpr std::size_t TAG_COUNT = 2;
+
+struct Grid {
+    std::size_t rows;
+    std::size_t cols;
+
+    std::size_t size() const { return rows * cols; }
+    std::size_t row_of(std::size_t rank) const { return rank / cols; }
+    std::size_t col_of(std::size_t rank) const { return rank % cols; }
+};
+
+struct Range {
+    std::size_t begin;
+    std::size_t end;
+
+    std::size_t size() const { return end - begin; }
+};
+
+// One step of the algorithm: shared-dimension slice [k.begin, k.end), owned
+// by grid column a_owner for A and grid row b_owner for B.
+struct Panel {
+    Range k;
+    std::size_t a_owner;
+    std::size_t b_owner;
+};
+
+struct RoundTiming {
+    Range k;
+    double communication_seconds;
+    double compute_seconds;
+};
+
+// Splits [0, extent) into `parts` ranges on REGISTER_TILE boundaries, so
+// every local block and panel keeps the kernels' padding rules.
+inline std::vector<std::size_t> partition(std::size_t extent, std::size_t parts) {
+    const std::size_t tiles = kernels::padded(extent) / kernels::REGISTER_TILE;
+    std::vector<std::size_t> bounds(parts + 1);
+    for (std::size_t p{}; p <= parts; ++p)
+        bounds[p] = std::min(tiles * p / parts * kernels::REGISTER_TILE, extent);
+    return bounds;
+}
+
+// Block ownership for an m x n x k product. A's columns are split across
+// grid columns and B's rows across grid rows, which need not line up; the
+// panels are cut at the union of both sets of bounds.
+class Distribution {
+private:
+    Grid grid_;
+    std::vector<std::size_t> row_bounds_;    // M over grid rows
+    std::vector<std::size_t> col_bounds_;    // N over grid cols
+    std::vector<std::size_t> a_k_bounds_;    // K over grid cols (A)
+    std::vector<std::size_t> b_k_bounds_;    // K over grid rows (B)
+    std::vector<Panel> panels_;
+
+    static std::size_t owner(const std::vector<std::size_t>& bounds, std::size_t k) {
+        return std::upper_bound(bounds.begin(), bounds.end(), k) - bounds.begin() - 1;
+    }
+
+public:
+    Distribution(Grid grid, std::size_t m, std::size_t n, std::size_t k)
+        : grid_(grid)
+        , row_bounds_(partition(m, grid.rows))
+        , col_bounds_(partition(n, grid.cols))
+        , a_k_bounds_(partition(k, grid.cols))
+        , b_k_bounds_(partition(k, grid.rows)) {
+        std::vector<std::size_t> cuts = a_k_bounds_;
+        cuts.insert(cuts.end(), b_k_bounds_.begin(), b_k_bounds_.end());
+        std::ranges::sort(cuts);
+        const auto [first, last] = std::ranges::unique(cuts);
+        cuts.erase(first, last);
+
+        for (std::size_t i = 1; i < cuts.size(); ++i)
+            panels_.push_back({{cuts[i - 1], cuts[i]}, owner(a_k_bounds_, cuts[i - 1]), owner(b_k_bounds_, cuts[i - 1])});
+    }
+
+    const Grid& grid() const { return grid_; }
+    const std::vector<Panel>& panels() const { return panels_; }
+
+    Range c_rows(std::size_t rank) const { return {row_bounds_[grid_.row_of(rank)], row_bounds_[grid_.row_of(rank) + 1]}; }
+    Range c_cols(std::size_t rank) const { return {col_bounds_[grid_.col_of(rank)], col_bounds_[grid_.col_of(rank) + 1]}; }
+    Range a_cols(std::size_t rank) const { return {a_k_bounds_[grid_.col_of(rank)], a_k_bounds_[grid_.col_of(rank) + 1]}; }
+    Range b_rows(std::size_t rank) const { return {b_k_bounds_[grid_.row_of(rank)], b_k_bounds_[grid_.row_of(rank) + 1]}; }
+
+    // Largest panel any rank sends, for sizing transport buffers.
+    template<typename T>
+    std::size_t max_message_bytes() const {
+        std::size_t rows{}, cols{}, depth{};
+        for (std::size_t r = 0; r < grid_.rows; ++r)
+            rows = std::max(rows, row_bounds_[r + 1] - row_bounds_[r]);
+        for (std::size_t c = 0; c < grid_.cols; ++c)
+            cols = std::max(cols, col_bounds_[c + 1] - col_bounds_[c]);
+        for (const auto& panel: panels_)
+            depth = std::max(depth, panel.k.size());
+        return std::max(kernels::padded(rows), kernels::padded(cols)) * kernels::padded(depth) * sizeof(T);
+    }
+};
+
+// Copies global[rows, cols] into a new padded block.
+template<typename T>
+Matrix<T> slice(const Matrix<T>& global, Range rows, Range cols) {
+    Matrix<T> block(rows.size(), cols.size());
+    for (std::size_t y{}; y < rows.size(); ++y)
+        std::copy_n(global.data() + (rows.begin + y) * global.stride() + cols.begin, cols.size(), block.data() + y * block.stride());
+    return block;
+}
+
+template<typename T>
+std::span<std::byte> bytes_of(Matrix<T>& block) {
+    return std::as_writable_bytes(std::span(block.data(), block.padded_rows() * block.stride()));
+}
+
+// c_local = (A * B) block of this rank, from its a_local (c_rows x a_cols)
+// and b_local (b_rows x c_cols) blocks. Returns per-panel timings.
+template<typename T>
+std::vector<RoundTiming> multiply(
+    Transport& transport,
+    const Distribution& distribution,
+    const Matrix<T>& a_local,
+    const Matrix<T>& b_local,
+    Matrix<T>& c_local,
+    std::size_t threads = 1
+) {
+    using clock = std::chrono::steady_clock;
+
+    const Grid& grid = distribution.grid();
+    const std::size_t rank = transport.rank();
+    const std::size_t grid_row = grid.row_of(rank);
+    const std::size_t grid_col = grid.col_of(rank);
+    const Range rows = distribution.c_rows(rank);
+    const Range cols = distribution.c_cols(rank);
+    assert(transport.size() == grid.size() && "grid does not match the transport");
+    assert(c_local.rows() == rows.size() && c_local.cols() == cols.size() && "C block has the wrong shape");
+
+    std::vector<std::size_t> row_group(grid.cols), col_group(grid.rows);
+    for (std::size_t c = 0; c < grid.cols; ++c)
+        row_group[c] = grid_row * grid.cols + c;
+    for (std::size_t r = 0; r < grid.rows; ++r)
+        col_group[r] = r * grid.cols + grid_col;
+
+    std::fill(c_local.data(), c_local.data() + c_local.padded_rows() * c_local.stride(), T{});
+
+    std::vector<RoundTiming> timings;
+    timings.reserve(distribution.panels().size());
+
+    for (const Panel& panel: distribution.panels()) {
+        const auto start = clock::now();
+
+        Matrix<T> a_panel(rows.size(), panel.k.size());
+        if (grid_col == panel.a_owner) {
+            const std::size_t offset = panel.k.begin - distribution.a_cols(rank).begin;
+            a_panel = slice(a_local, {0, rows.size()}, {offset, offset + panel.k.size()});
+        }
+        transport.broadcast(bytes_of(a_panel), grid_row * grid.cols + panel.a_owner, row_group, ROW_TAG);
+
+        Matrix<T> b_panel(panel.k.size(), cols.size());
+        if (grid_row == panel.b_owner) {
+            const std::size_t offset = panel.k.begin - distribution.b_rows(rank).begin;
+            b_panel = slice(b_local, {offset, offset + panel.k.size()}, {0, cols.size()});
+        }
+        transport.broadcast(bytes_of(b_panel), panel.b_owner * grid.cols + grid_col, col_group, COLUMN_TAG);
+
+        const auto communicated = clock::now();
+        kernels::multiply_tiled_registers(
+            a_panel.data(),  a_panel.stride(),
+            b_panel.data(),  b_panel.stride(),
+            c_local.data(),  c_local.stride(),
+            a_panel.padded_rows(), b_panel.stride(), a_panel.stride(),
+            threads,
+            {a_panel.rows(), b_panel.cols(), a_panel.cols()}
+        );
+        const auto computed = clock::now();
+
+        timings.push_back({
+            panel.k,
+            std::chrono::duration<double>(communicated - start).count(),
+            std::chrono::duration<double>(computed - communicated).count(),
+        });
+    }
+    return timings;
+}
+
+} // namespace summa
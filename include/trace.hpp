@@ -0,0 +1,277 @@
+#pragma once
+
+// Hot-path tracing for the GEMM kernels.
+//
+// Build with -DGEMM_TRACE (or the GEMM_ENABLE_TRACE cmake option) to record
+// rdtsc-based spans. Without it GEMM_TRACE_SPAN expands to nothing and the
+// export functions are empty inlines, so release builds pay nothing.
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+#if defined(GEMM_TRACE)
+#include <algorithm>
+#include <bit>
+#include <chrono>
+#include <fstream>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <x86intrin.h>
+#endif
+
+namespace trace {
+
+enum class Span : std::uint8_t {
+    MULTIPLY,    // whole multiply call
+    TILE_ROW,    // one i iteration of the tile loops
+    TILE_PANEL,  // one (i, k) iteration: pack A + sweep over j
+    PACK,        // pack_tile_linearly
+    MICROKERNEL, // microkernel_6x2
+    C_LOAD,      // C tile load into registers
+    C_STORE,     // C tile store from registers
+    COUNT
+};
+
+inline constexpr std::size_t SPAN_COUNT = static_cast<std::size_t>(Span::COUNT);
+
+inline constexpr std::array<std::string_view, SPAN_COUNT> SPAN_NAMES = {
+    "multiply", "tile_row", "tile_panel", "pack", "microkernel", "c_load", "c_store"
+};
+
+#if defined(GEMM_TRACE)
+
+inline constexpr bool ENABLED = true;
+
+// Bucket b holds durations in [2^b, 2^(b+1)) cycles.
+struct Histogram {
+    static constexpr std::size_t BUCKETS = 48;
+
+    std::uint64_t count{};
+    std::uint64_t total{};
+    std::uint64_t min = std::numeric_limits<std::uint64_t>::max();
+    std::uint64_t max{};
+    std::array<std::uint64_t, BUCKETS> buckets{};
+
+    void add(std::uint64_t cycles) {
+        ++count;
+        total += cycles;
+        min = std::min(min, cycles);
+        max = std::max(max, cycles);
+        const std::size_t b = cycles == 0 ? 0 : std::bit_width(cycles) - 1;
+        ++buckets[std::min(b, BUCKETS - 1)];
+    }
+};
+
+struct Event {
+    std::uint64_t start;
+    std::uint32_t cycles;
+    Span span;
+};
+
+struct ThreadLog {
+    // Events past this are dropped; histograms keep counting.
+    static constexpr std::size_t MAX_EVENTS = 1 << 20;
+
+    std::uint32_t tid;
+    std::array<Histogram, SPAN_COUNT> histograms{};
+    std::vector<Event> events;
+
+    explicit ThreadLog(std::uint32_t id): tid(id) {
+        events.reserve(4096);
+    }
+
+    void record(Span span, std::uint64_t start, std::uint64_t end) {
+        const std::uint64_t cycles = end - start;
+        histograms[static_cast<std::size_t>(span)].add(cycles);
+        if (events.size() < MAX_EVENTS)
+            events.push_back({start, static_cast<std::uint32_t>(cycles), span});
+    }
+};
+
+// Owns every thread's log so spans survive the threads that produced them.
+class Registry {
+private:
+    std::mutex mutex_;
+    std::vector<std::unique_ptr<ThreadLog>> logs_;
+
+    std::uint64_t tsc_origin_ = __rdtsc();
+    std::chrono::steady_clock::time_point clock_origin_ = std::chrono::steady_clock::now();
+
+public:
+    static Registry& instance() {
+        static Registry registry;
+        return registry;
+    }
+
+    ThreadLog* attach() {
+        std::lock_guard lock(mutex_);
+        const auto tid = static_cast<std::uint32_t>(logs_.size());
+        return logs_.emplace_back(std::make_unique<ThreadLog>(tid)).get();
+    }
+
+    // Callers must make sure no traced work is running concurrently.
+    template<typename Fn>
+    void for_each(Fn&& fn) {
+        std::lock_guard lock(mutex_);
+        for (const auto& log: logs_)
+            fn(*log);
+    }
+
+    void reset() {
+        std::lock_guard lock(mutex_);
+        for (auto& log: logs_) {
+            log->histograms = {};
+            log->events.clear();
+        }
+    }
+
+    std::uint64_t tsc_origin() const { return tsc_origin_; }
+
+    // TSC ticks per microsecond, calibrated against steady_clock since the
+    // registry was created.
+    double ticks_per_us() const {
+        using namespace std::chrono;
+        auto elapsed = steady_clock::now() - clock_origin_;
+        if (elapsed < milliseconds(10)) {
+            std::this_thread::sleep_for(milliseconds(10) - elapsed);
+            elapsed = steady_clock::now() - clock_origin_;
+        }
+        const double us = duration<double, std::micro>(elapsed).count();
+        return static_cast<double>(__rdtsc() - tsc_origin_) / us;
+    }
+};
+
+inline ThreadLog& thread_log() {
+    thread_local ThreadLog* log = Registry::instance().attach();
+    return *log;
+}
+
+class [[nodiscard]] ScopedSpan {
+private:
+    ThreadLog& log_;
+    Span span_;
+    std::uint64_t start_;
+
+public:
+    // The log is fetched first so the registry's tsc origin precedes start_.
+    explicit ScopedSpan(Span span): log_(thread_log()), span_(span), start_(__rdtsc()) {}
+
+    ScopedSpan(const ScopedSpan&) = delete;
+    ScopedSpan& operator=(const ScopedSpan&) = delete;
+
+    ~ScopedSpan() {
+        log_.record(span_, start_, __rdtsc());
+    }
+};
+
+inline void reset() {
+    Registry::instance().reset();
+}
+
+// Histograms summed over every thread, indexed by Span.
+inline std::array<Histogram, SPAN_COUNT> merged_histograms() {
+    std::array<Histogram, SPAN_COUNT> merged{};
+    Registry::instance().for_each([&](const ThreadLog& log) {
+        for (std::size_t s{}; s < SPAN_COUNT; ++s) {
+            const Histogram& h = log.histograms[s];
+            merged[s].count += h.count;
+            merged[s].total += h.total;
+            merged[s].min = std::min(merged[s].min, h.min);
+            merged[s].max = std::max(merged[s].max, h.max);
+            for (std::size_t b{}; b < Histogram::BUCKETS; ++b)
+                merged[s].buckets[b] += h.buckets[b];
+        }
+    });
+    return merged;
+}
+
+// Chrome trace event format, loadable by chrome://tracing and Perfetto.
+inline bool write_chrome_trace(const char* path) {
+    std::ofstream out(path);
+    if (!out)
+        return false;
+
+    auto& registry = Registry::instance();
+    const double ticks_per_us = registry.ticks_per_us();
+    const std::uint64_t origin = registry.tsc_origin();
+
+    out << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[";
+    bool first = true;
+    registry.for_each([&](const ThreadLog& log) {
+        for (const Event& e: log.events) {
+            out << (first ? "" : ",") << '\n'
+                << "{\"name\":\"" << SPAN_NAMES[static_cast<std::size_t>(e.span)]
+                << "\",\"ph\":\"X\",\"pid\":0,\"tid\":" << log.tid
+                << ",\"ts\":" << static_cast<double>(e.start - origin) / ticks_per_us
+                << ",\"dur\":" << static_cast<double>(e.cycles) / ticks_per_us
+                << "}";
+            first = false;
+        }
+    });
+    out << "\n]}\n";
+    return static_cast<bool>(out);
+}
+
+// Per-thread cycle histograms as JSON.
+inline bool write_histograms(const char* path) {
+    std::ofstream out(path);
+    if (!out)
+        return false;
+
+    auto write_histogram = [&](const Histogram& h) {
+        out << "{\"count\":" << h.count
+            << ",\"total_cycles\":" << h.total
+            << ",\"min_cycles\":" << (h.count ? h.min : 0)
+            << ",\"max_cycles\":" << h.max
+            << ",\"log2_buckets\":[";
+        for (std::size_t b{}; b < Histogram::BUCKETS; ++b)
+            out << (b ? "," : "") << h.buckets[b];
+        out << "]}";
+    };
+
+    auto write_spans = [&](const std::array<Histogram, SPAN_COUNT>& histograms) {
+        out << '{';
+        for (std::size_t s{}; s < SPAN_COUNT; ++s) {
+            out << (s ? "," : "") << '"' << SPAN_NAMES[s] << "\":";
+            write_histogram(histograms[s]);
+        }
+        out << '}';
+    };
+
+    out << "{\"ticks_per_us\":" << Registry::instance().ticks_per_us() << ",\"threads\":[";
+    bool first = true;
+    Registry::instance().for_each([&](const ThreadLog& log) {
+        out << (first ? "" : ",") << "\n{\"tid\":" << log.tid << ",\"spans\":";
+        write_spans(log.histograms);
+        out << '}';
+        first = false;
+    });
+    out << "\n],\"total\":";
+    write_spans(merged_histograms());
+    out << "}\n";
+    return static_cast<bool>(out);
+}
+
+#define GEMM_TRACE_CONCAT_(a, b) a##b
+#define GEMM_TRACE_CONCAT(a, b) GEMM_TRACE_CONCAT_(a, b)
+#define GEMM_TRACE_SPAN(span) \
+    ::trace::ScopedSpan GEMM_TRACE_CONCAT(gemm_trace_span_, __LINE__){::trace::Span::span}
+
+#else
+
+inline constexpr bool ENABLED = false;
+
+inline void reset() {}
+inline bool write_chrome_trace(const char*) { return false; }
+inline bool write_histograms(const char*) { return false; }
+
+#define GEMM_TRACE_SPAN(span) static_cast<void>(0)
+
+#endif
+
+} // namespace trace
@@ -0,0 +1,222 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+enum class Priority : std::uint8_t { HIGH, NORMAL, LOW };
+
+inline constexpr std::size_t PRIORITY_COUNT = 3;
+
+// Thread pool running jobs made of independent tiles.
+//
+// Every worker owns one deque per priority. A queue entry is a reference to a
+// job, not a single tile: whoever pops it claims the job's next tile and, if
+// tiles remain, pushes the entry to the back of its own deque before running
+// the claimed one. A large job therefore occupies a single queue slot in
+// total, moving from deque to deque as workers claim and steal it. Jobs of
+// equal priority are serviced round-robin, and a small job submitted behind
+// an 8192 multiply waits for a tile rather than the whole product. Idle
+// workers steal from the other deques, higher priorities first.
+class WorkStealingPool {
+public:
+    struct Metrics {
+        std::array<std::size_t, PRIORITY_COUNT> queued_jobs;    // submitted, not finished
+        std::array<std::size_t, PRIORITY_COUNT> pending_tiles;  // not yet claimed
+        std::size_t active_workers;
+        std::size_t completed_jobs;
+        std::size_t steals;
+    };
+
+private:
+    struct Job {
+        std::function<void(std::size_t)> fn;
+        std::size_t tiles;
+        Priority priority;
+        std::atomic<std::size_t> next{};
+        std::atomic<std::size_t> done{};
+        std::once_flag failed;
+        std::exception_ptr error;
+        std::promise<void> promise;
+    };
+
+    using JobPtr = std::shared_ptr<Job>;
+
+    struct alignas(64) Queue {
+        std::mutex mutex;
+        std::array<std::deque<JobPtr>, PRIORITY_COUNT> lanes;
+    };
+
+    std::vector<std::unique_ptr<Queue>> queues_;
+    std::vector<std::jthread> workers_;
+
+    std::mutex sleep_mutex_;
+    std::condition_variable wake_;
+    std::atomic<std::size_t> entries_{};
+    std::atomic<bool> stopping_{};
+    std::atomic<std::size_t> next_queue_{};
+
+    std::array<std::atomic<std::size_t>, PRIORITY_COUNT> queued_jobs_{};
+    std::array<std::atomic<std::size_t>, PRIORITY_COUNT> pending_tiles_{};
+    std::atomic<std::size_t> active_workers_{};
+    std::atomic<std::size_t> completed_jobs_{};
+    std::atomic<std::size_t> steals_{};
+
+    static std::size_t lane(Priority priority) {
+        return static_cast<std::size_t>(priority);
+    }
+
+    void push(std::size_t queue, JobPtr job) {
+        {
+            std::lock_guard lock(queues_[queue]->mutex);
+            queues_[queue]->lanes[lane(job->priority)].push_back(std::move(job));
+        }
+        entries_.fetch_add(1, std::memory_order_release);
+        { std::lock_guard lock(sleep_mutex_); }
+        wake_.notify_one();
+    }
+
+    JobPtr pop(std::size_t self) {
+        for (std::size_t p{}; p < PRIORITY_COUNT; ++p) {
+            {
+                auto& own = *queues_[self];
+                std::lock_guard lock(own.mutex);
+                if (!own.lanes[p].empty()) {
+                    JobPtr job = std::move(own.lanes[p].front());
+                    own.lanes[p].pop_front();
+                    entries_.fetch_sub(1, std::memory_order_relaxed);
+                    return job;
+                }
+            }
+            for (std::size_t offset = 1; offset < queues_.size(); ++offset) {
+                auto& victim = *queues_[(self + offset) % queues_.size()];
+                std::lock_guard lock(victim.mutex);
+                if (!victim.lanes[p].empty()) {
+                    JobPtr job = std::move(victim.lanes[p].back());
+                    victim.lanes[p].pop_back();
+                    entries_.fetch_sub(1, std::memory_order_relaxed);
+                    steals_.fetch_add(1, std::memory_order_relaxed);
+                    return job;
+                }
+            }
+        }
+        return nullptr;
+    }
+
+    void run_tile(std::size_t self, const JobPtr& job) {
+        const std::size_t tile = job->next.fetch_add(1, std::memory_order_relaxed);
+        if (tile >= job->tiles)
+            return;
+
+        pending_tiles_[lane(job->priority)].fetch_sub(1, std::memory_order_relaxed);
+        if (tile + 1 < job->tiles)
+            push(self, job);
+
+        try {
+            job->fn(tile);
+        } catch (...) {
+            std::call_once(job->failed, [&] { job->error = std::current_exception(); });
+        }
+
+        if (job->done.fetch_add(1, std::memory_order_acq_rel) + 1 == job->tiles) {
+            queued_jobs_[lane(job->priority)].fetch_sub(1, std::memory_order_relaxed);
+            completed_jobs_.fetch_add(1, std::memory_order_relaxed);
+            if (job->error)
+                job->promise.set_exception(job->error);
+            else
+                job->promise.set_value();
+        }
+    }
+
+    void worker_loop(std::size_t self) {
+        while (true) {
+            if (JobPtr job = pop(self)) {
+                active_workers_.fetch_add(1, std::memory_order_relaxed);
+                run_tile(self, job);
+                active_workers_.fetch_sub(1, std::memory_order_relaxed);
+                continue;
+            }
+
+            std::unique_lock lock(sleep_mutex_);
+            wake_.wait(lock, [&] {
+                return entries_.load(std::memory_order_acquire) > 0 || stopping_.load();
+            });
+            if (stopping_.load() && entries_.load() == 0)
+                return;
+        }
+    }
+
+public:
+    explicit WorkStealingPool(std::size_t workers = std::thread::hardware_concurrency()) {
+        workers = std::max<std::size_t>(workers, 1);
+        for (std::size_t w{}; w < workers; ++w)
+            queues_.push_back(std::make_unique<Queue>());
+        for (std::size_t w{}; w < workers; ++w)
+            workers_.emplace_back([this, w] { worker_loop(w); });
+    }
+
+    WorkStealingPool(const WorkStealingPool&) = delete;
+    WorkStealingPool& operator=(const WorkStealingPool&) = delete;
+
+    // Finishes every queued job, then joins.
+    ~WorkStealingPool() {
+        {
+            std::lock_guard lock(sleep_mutex_);
+            stopping_ = true;
+        }
+        wake_.notify_all();
+        workers_.clear();
+    }
+
+    std::size_t size() const {
+        return workers_.size();
+    }
+
+    // Runs fn(tile) for every tile in [0, tiles), possibly concurrently. The
+    // future becomes ready once all tiles have run and carries the first
+    // exception any of them threw.
+    std::future<void> submit(
+        std::size_t tiles,
+        std::function<void(std::size_t)> fn,
+        Priority priority = Priority::NORMAL
+    ) {
+        auto job = std::make_shared<Job>();
+        job->fn = std::move(fn);
+        job->tiles = tiles;
+        job->priority = priority;
+        auto future = job->promise.get_future();
+
+        if (tiles == 0) {
+            job->promise.set_value();
+            return future;
+        }
+
+        queued_jobs_[lane(priority)].fetch_add(1, std::memory_order_relaxed);
+        pending_tiles_[lane(priority)].fetch_add(tiles, std::memory_order_relaxed);
+        push(next_queue_.fetch_add(1, std::memory_order_relaxed) % queues_.size(), std::move(job));
+        return future;
+    }
+
+    Metrics metrics() const {
+        Metrics m{};
+        for (std::size_t p{}; p < PRIORITY_COUNT; ++p) {
+            m.queued_jobs[p] = queued_jobs_[p].load(std::memory_order_relaxed);
+            m.pending_tiles[p] = pending_tiles_[p].load(std::memory_order_relaxed);
+        }
+        m.active_workers = active_workers_.load(std::memory_order_relaxed);
+        m.completed_jobs = completed_jobs_.load(std::memory_order_relaxed);
+        m.steals = steals_.load(std::memory_order_relaxed);
+        return m;
+    }
+};
@@ -0,0 +1,57 @@
+#include <array>
+#include <cassert>
+#include <complex>
+#include <cstddef>
+#include <cstdint>
+#include "../include/matrix.hpp"
+
+template<typename T>
+Matrix<std::complex<T>> make_complex(std::size_t rows, std::size_t cols, std::uint64_t seed) {
+    const auto re = Matrix<T>::make_random(rows, cols, -9, 9, seed);
+    const auto im = Matrix<T>::make_random(rows, cols, -9, 9, seed + 1);
+    Matrix<std::complex<T>> out(rows, cols);
+    for (std::size_t y = 0; y < rows; ++y)
+        for (std::size_t x = 0; x < cols; ++x)
+            out.set(x, y, {re.get(x, y), im.get(x, y)});
+    return out;
+}
+
+// Both methods against a scalar complex loop, over ragged shapes. Entries
+// are small integers, so every partial sum either method forms is exact.
+template<typename T>
+void check_methods() {
+    using complex_gemm::Method;
+    for (auto [m, n, k] : {std::array<std::size_t, 3>{3, 5, 7}, {50, 7, 100}, {97, 145, 33}}) {
+        const auto A = make_complex<T>(m, k, 11);
+        const auto B = make_complex<T>(k, n, 13);
+
+        Matrix<std::complex<T>> expected(m, n);
+        for (std::size_t y = 0; y < m; ++y) {
+            for (std::size_t x = 0; x < n; ++x) {
+                std::complex<T> sum{};
+                for (std::size_t i = 0; i < k; ++i)
+                    sum += A.get(i, y) * B.get(x, i);
+                expected.set(x, y, sum);
+            }
+        }
+
+        for (Method method : {Method::FOUR_M, Method::THREE_M}) {
+            for (std::size_t threads : {1, 3}) {
+                Matrix<std::complex<T>> out(m, n);
+                A.multiply(B, out, method, threads);
+                for (std::size_t y = 0; y < m; ++y)
+                    for (std::size_t x = 0; x < n; ++x)
+                        assert(out.get(x, y) == expected.get(x, y) && "complex product mismatch");
+                for (std::size_t y = 0; y < out.padded_rows(); ++y)
+                    for (std::size_t x = (y < m ? n : 0); x < out.stride(); ++x)
+                        assert(out.data()[y * out.stride() + x] == std::complex<T>{} && "padding written");
+            }
+        }
+    }
+}
+
+int main() {
+    check_methods<float>();
+    check_methods<double>();
+    return 0;
+}
@@ -0,0 +1,91 @@
+#include <cassert>
+#include <random>
+#include <vector>
+#include "../include/conv.hpp"
+
+// Direct seven-loop convolution in either format.
+std::vector<int> reference(const conv::Shape& s, conv::Format format, const std::vector<int>& input, const std::vector<int>& weights) {
+    const std::size_t out_h = s.out_height(), out_w = s.out_width();
+    auto in_index = [&](std::size_t n, std::size_t c, std::size_t y, std::size_t x) {
+        return format == conv::Format::NCHW ? ((n * s.in_channels + c) * s.height + y) * s.width + x
+                                            : ((n * s.height + y) * s.width + x) * s.in_channels + c;
+    };
+    auto out_index = [&](std::size_t n, std::size_t c, std::size_t y, std::size_t x) {
+        return format == conv::Format::NCHW ? ((n * s.out_channels + c) * out_h + y) * out_w + x
+                                            : ((n * out_h + y) * out_w + x) * s.out_channels + c;
+    };
+
+    std::vector<int> output(s.output_size());
+    for (std::size_t n{}; n < s.batch; ++n)
+        for (std::size_t co{}; co < s.out_channels; ++co)
+            for (std::size_t oy{}; oy < out_h; ++oy)
+                for (std::size_t ox{}; ox < out_w; ++ox) {
+                    int sum{};
+                    for (std::size_t ci{}; ci < s.in_channels; ++ci)
+                        for (std::size_t ky{}; ky < s.kernel_h; ++ky)
+                            for (std::size_t kx{}; kx < s.kernel_w; ++kx) {
+                                const auto y = static_cast<std::ptrdiff_t>(oy * s.stride_h + ky * s.dilation_h) - static_cast<std::ptrdiff_t>(s.pad_h);
+                                const auto x = static_cast<std::ptrdiff_t>(ox * s.stride_w + kx * s.dilation_w) - static_cast<std::ptrdiff_t>(s.pad_w);
+                                if (y < 0 || x < 0 || y >= static_cast<std::ptrdiff_t>(s.height) || x >= static_cast<std::ptrdiff_t>(s.width))
+                                    continue;
+                                sum += input[in_index(n, ci, y, x)] * weights[((co * s.in_channels + ci) * s.kernel_h + ky) * s.kernel_w + kx];
+                            }
+                    output[out_index(n, co, oy, ox)] = sum;
+                }
+    return output;
+}
+
+std::vector<int> random_vector(std::size_t size, std::mt19937& gen) {
+    std::uniform_int_distribution<> distrib(-4, 4);
+    std::vector<int> values(size);
+    for (auto& v : values)
+        v = distrib(gen);
+    return values;
+}
+
+int main() {
+    std::mt19937 gen(7);
+
+    // output extents
+    {
+        const conv::Shape s{.batch = 1, .in_channels = 3, .height = 32, .width = 31, .out_channels = 8,
+                            .kernel_h = 3, .kernel_w = 5, .stride_h = 2, .stride_w = 1, .pad_h = 1, .pad_w = 2, .dilation_w = 2};
+        assert(s.out_height() == 16 && s.out_width() == 27 && "output extents");
+        assert(s.depth() == 45 && s.pixels() == 16 * 27 && "GEMM extents");
+    }
+
+    // implicit GEMM vs direct convolution
+    const conv::Shape shapes[] = {
+        {.batch = 1, .in_channels = 1, .height = 5, .width = 5, .out_channels = 1, .kernel_h = 3, .kernel_w = 3},
+        {.batch = 2, .in_channels = 3, .height = 17, .width = 13, .out_channels = 50, .kernel_h = 3, .kernel_w = 3, .pad_h = 1, .pad_w = 1},
+        {.batch = 3, .in_channels = 7, .height = 20, .width = 23, .out_channels = 5, .kernel_h = 5, .kernel_w = 3,
+         .stride_h = 2, .stride_w = 3, .pad_h = 2, .pad_w = 1},
+        {.batch = 1, .in_channels = 20, .height = 15, .width = 16, .out_channels = 97, .kernel_h = 3, .kernel_w = 3,
+         .pad_h = 2, .pad_w = 2, .dilation_h = 2, .dilation_w = 2},
+        {.batch = 2, .in_channels = 64, .height = 9, .width = 9, .out_channels = 48, .kernel_h = 1, .kernel_w = 1},
+        {.batch = 1, .in_channels = 2, .height = 6, .width = 40, .out_channels = 3, .kernel_h = 1, .kernel_w = 7,
+         .stride_w = 4, .pad_w = 5, .dilation_w = 3},
+    };
+
+    for (const auto& shape : shapes) {
+        for (auto format : {conv::Format::NCHW, conv::Format::NHWC}) {
+            const auto input = random_vector(shape.input_size(), gen);
+            const auto weights = random_vector(shape.weight_size(), gen);
+            const auto expected = reference(shape, format, input, weights);
+
+            std::vector<int> output(shape.output_size(), -1);
+            conv::conv2d<int>(shape, format, input, weights, output);
+            assert(output == expected && "conv2d check failed");
+
+            // reused weights, threaded
+            const conv::Conv2d<int> layer(shape, format, weights);
+            for (std::size_t threads : {2, 3}) {
+                std::vector<int> threaded(shape.output_size(), -1);
+                layer.run(input, threaded, threads);
+                assert(threaded == expected && "threaded conv2d check failed");
+            }
+        }
+    }
+
+    return 0;
+}
@@ -0,0 +1,134 @@
+#include <cassert>
+#include <cstddef>
+#include "../include/mat.hpp"
+#include "../include/matrix.hpp"
+
+void check_decision_table() {
+    using dispatch::Engine;
+    auto decide = [](Engine engine, std::size_t m, std::size_t n, std::size_t k, std::size_t limit = 1) {
+        return dispatch::decide(dispatch::problem<float>(engine, m, n, k), limit);
+    };
+
+    // tiny products stay scalar
+    assert((decide(Engine::SQUARE, 16, 16, 16) == dispatch::Choice{Impl::NAIVE, 1}));
+    assert((decide(Engine::RUNTIME, 4, 100, 8) == dispatch::Choice{Impl::NAIVE, 1}));
+
+    // 32-wide tiles where padding to 48 wastes work, register tiles otherwise
+    assert((decide(Engine::SQUARE, 32, 32, 32) == dispatch::Choice{Impl::TILED_SIMD, 1}));
+    assert((decide(Engine::SQUARE, 64, 64, 64) == dispatch::Choice{Impl::TILED_SIMD, 1}));
+    assert((decide(Engine::SQUARE, 48, 48, 48) == dispatch::Choice{Impl::TILED_REGISTERS, 1}));
+    assert((decide(Engine::SQUARE, 512, 512, 512) == dispatch::Choice{Impl::TILED_REGISTERS, 1}));
+    assert((decide(Engine::SQUARE_TILED, 64, 64, 64) == dispatch::Choice{Impl::TILED_REGISTERS, 1}));
+    assert((decide(Engine::RUNTIME, 30, 30, 30) == dispatch::Choice{Impl::TILED_REGISTERS, 1}));
+
+    // threads only for large products, capped by the limit and the row tiles
+    assert((decide(Engine::SQUARE, 128, 128, 128, 8) == dispatch::Choice{Impl::TILED_SIMD, 1}));
+    assert((decide(Engine::SQUARE, 512, 512, 512, 4) == dispatch::Choice{Impl::TILED_REGISTERS, 4}));
+    assert((decide(Engine::RUNTIME, 96, 2000, 2000, 8) == dispatch::Choice{Impl::TILED_REGISTERS, 2}));
+}
+
+// AUTO overwrites even when it picks an accumulating kernel, so reusing
+// out across calls must not change the result.
+template<typename Square, typename Expected>
+void check_auto(const Square& a, const Square& b, const Expected& expected, std::size_t n) {
+    Square out{};
+    for (std::size_t threads : {0, 1, 3}) {
+        a.multiply(b, out, Impl::AUTO, threads);
+        for (std::size_t y = 0; y < n; ++y)
+            for (std::size_t x = 0; x < n; ++x)
+                assert(out.get(x, y) == expected.get(x, y) && "AUTO square mismatch");
+    }
+}
+
+template<std::size_t N>
+void check_square() {
+    const auto A = SquareMatrix<int, N>::make_random(-10, 10);
+    const auto B = SquareMatrix<int, N>::make_random(-10, 10);
+    SquareMatrix<int, N> expected{};
+    A.multiply(B, expected, Impl::NAIVE);
+
+    check_auto(A, B, expected, N);
+    check_auto(A.template to<layout::BlockMajor>(), B.template to<layout::BlockMajor>(), expected, N);
+}
+
+void check_runtime() {
+    for (auto [m, n, k] : {std::array<std::size_t, 3>{3, 5, 7}, {50, 7, 100}, {97, 145, 33}}) {
+        const auto A = Matrix<int>::make_random(m, k, -10, 10);
+        const auto B = Matrix<int>::make_random(k, n, -10, 10);
+        Matrix<int> expected(m, n), out(m, n);
+        A.multiply(B, expected, Impl::NAIVE);
+        A.multiply(B, out);
+        assert(out == expected && "AUTO Matrix mismatch");
+    }
+}
+
+void check_refinement() {
+    dispatch::set_refinement(true);
+    const auto problem = dispatch::problem<int>(dispatch::Engine::SQUARE, 64, 64, 64);
+    const std::size_t trials = 2 * dispatch::candidates(problem, 1).size();
+
+    const auto A = SquareMatrix<int, 64>::make_random(-10, 10);
+    const auto B = SquareMatrix<int, 64>::make_random(-10, 10);
+    SquareMatrix<int, 64> expected{};
+    A.multiply(B, expected, Impl::NAIVE);
+
+    // every trial, whichever kernel it runs, gives the right answer
+    for (std::size_t call{}; call < trials; ++call) {
+        assert(!dispatch::tuner().settled(problem, 1) && "settled before all trials ran");
+        SquareMatrix<int, 64> out{};
+        A.multiply(B, out, Impl::AUTO, 1);
+        assert(out == expected && "trial result mismatch");
+    }
+
+    const auto winner = dispatch::tuner().settled(problem, 1);
+    assert(winner && "refinement did not settle");
+    const auto candidates = dispatch::candidates(problem, 1);
+    assert(std::ranges::find(candidates, *winner) != candidates.end() && "winner is not a candidate");
+
+    SquareMatrix<int, 64> out{};
+    A.multiply(B, out, Impl::AUTO, 1);
+    assert(out == expected && "settled result mismatch");
+
+    dispatch::set_refinement(false);
+    dispatch::tuner().clear();
+}
+
+// A winner settled under a high thread limit must not leak to a caller that
+// asked for fewer threads.
+void check_refinement_limit() {
+    dispatch::set_refinement(true);
+    const auto problem = dispatch::problem<float>(dispatch::Engine::SQUARE, 512, 512, 512);
+
+    // make the widest candidate win
+    for (;;) {
+        const auto [choice, trial] = dispatch::tuner().choose(problem, 8);
+        if (!trial)
+            break;
+        dispatch::tuner().record(problem, 8, choice, 1.0 / static_cast<double>(choice.threads));
+    }
+    const auto winner = dispatch::tuner().settled(problem, 8);
+    assert(winner && winner->threads == 8 && "refinement did not settle on the widest candidate");
+
+    for (std::size_t call{}; call < 2 * dispatch::candidates(problem, 1).size() + 1; ++call) {
+        const auto [choice, trial] = dispatch::tuner().choose(problem, 1);
+        assert(choice.threads == 1 && "choice exceeds the caller's thread limit");
+        if (trial)
+            dispatch::tuner().record(problem, 1, choice, 1.0);
+    }
+    assert(dispatch::tuner().settled(problem, 1) && "limit-1 refinement did not settle");
+
+    dispatch::set_refinement(false);
+    dispatch::tuner().clear();
+}
+
+int main() {
+    check_decision_table();
+    check_square<8>();
+    check_square<32>();
+    check_square<96>();
+    check_square<100>();
+    check_runtime();
+    check_refinement();
+    check_refinement_limit();
+    return 0;
+}
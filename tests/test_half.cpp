@@ -0,0 +1,88 @@
+#include <cassert>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+#include "../include/matrix.hpp"
+
+template<typename H>
+void check_round_trip() {
+    // every 16-bit pattern survives widening and narrowing
+    for (std::uint32_t bits = 0; bits <= 0xFFFF; ++bits) {
+        H h;
+        h.bits = static_cast<std::uint16_t>(bits);
+        const float f = h;
+        if (std::isnan(f))
+            assert(std::isnan(static_cast<float>(H(f))) && "NaN must stay NaN");
+        else
+            assert(H(f).bits == h.bits && "round trip changed the bits");
+    }
+
+    // vector widening and narrowing agree with the scalar conversions
+    std::vector<H> halves(37);
+    for (std::size_t i{}; i < halves.size(); ++i)
+        halves[i] = H(static_cast<float>(i) * 0.37f - 5.0f);
+    std::vector<float> floats(halves.size());
+    widen(halves.data(), floats.data(), halves.size());
+    for (std::size_t i{}; i < halves.size(); ++i)
+        assert(floats[i] == static_cast<float>(halves[i]) && "widen mismatch");
+
+    for (std::size_t i{}; i < floats.size(); ++i)
+        floats[i] = static_cast<float>(i) * 1.001f - 7.3f;
+    narrow(floats.data(), halves.data(), floats.size());
+    for (std::size_t i{}; i < floats.size(); ++i)
+        assert(halves[i].bits == H(floats[i]).bits && "narrow mismatch");
+}
+
+template<typename H>
+void check_multiply() {
+    for (auto [m, n, k] : {std::array<std::size_t, 3>{4, 4, 4}, {50, 7, 100}, {97, 145, 33}, {130, 60, 200}}) {
+        const auto A = Matrix<H>::make_random(m, k, H(-4.0f), H(4.0f));
+        const auto B = Matrix<H>::make_random(k, n, H(-4.0f), H(4.0f));
+
+        // small integers: every product and sum is exact in fp32
+        Matrix<float> expected(m, n);
+        for (std::size_t y = 0; y < m; ++y)
+            for (std::size_t x = 0; x < n; ++x) {
+                float sum{};
+                for (std::size_t i = 0; i < k; ++i)
+                    sum += static_cast<float>(A.get(i, y)) * static_cast<float>(B.get(x, i));
+                expected.set(x, y, sum);
+            }
+
+        for (std::size_t threads : {1, 3}) {
+            Matrix<float> wide(m, n);
+            A.multiply(B, wide, Impl::TILED_REGISTERS, threads);
+            assert(wide == expected && "fp32 output check failed");
+
+            Matrix<H> narrow_out(m, n);
+            A.multiply(B, narrow_out, Impl::TILED_REGISTERS, threads);
+            for (std::size_t y = 0; y < m; ++y)
+                for (std::size_t x = 0; x < n; ++x)
+                    assert(narrow_out.get(x, y).bits == H(expected.get(x, y)).bits && "16-bit output check failed");
+        }
+
+        Matrix<float> naive(m, n);
+        A.multiply(B, naive, Impl::NAIVE);
+        assert(naive == expected && "naive check failed");
+    }
+}
+
+int main() {
+    // rounding is to nearest, ties to even
+    {
+        assert(bf16(1.0f + 0x1p-8f).bits == bf16(1.0f).bits && "bf16 tie rounds to even");
+        assert(bf16(1.0f + 0x1p-7f + 0x1p-8f).bits == bf16(1.0f + 0x1p-6f).bits && "bf16 tie rounds to even");
+        assert(fp16(1.0f + 0x1p-11f).bits == 0x3C00 && "fp16 tie rounds to even");
+        assert(fp16(1.0f + 0x1p-10f + 0x1p-11f).bits == 0x3C02 && "fp16 tie rounds to even");
+        assert(fp16(65504.0f).bits == 0x7BFF && fp16(65520.0f).bits == 0x7C00 && "fp16 overflow");
+        assert(fp16(0x1p-24f).bits == 0x0001 && fp16(0x1p-25f).bits == 0x0000 && "fp16 subnormals");
+        assert(static_cast<float>(fp16(-0x1p-20f)) == -0x1p-20f && "fp16 negative subnormal");
+    }
+
+    check_round_trip<bf16>();
+    check_round_trip<fp16>();
+    check_multiply<bf16>();
+    check_multiply<fp16>();
+
+    return 0;
+}
@@ -0,0 +1,125 @@
+#include <cassert>
+#include <random>
+#include <vector>
+#include "../include/conv.hpp"
+#include "../include/matrix.hpp"
+
+// Built with GEMM_JIT; skips everything on hosts without AVX2/FMA.
+
+constexpr std::size_t TILE = jit::TILE;
+
+std::vector<float> random_floats(std::size_t size, std::mt19937& gen) {
+    std::uniform_int_distribution<> distrib(-8, 8);
+    std::vector<float> values(size);
+    for (auto& v : values)
+        v = static_cast<float>(distrib(gen));
+    return values;
+}
+
+int main() {
+    if (!jit::enabled())
+        return 0;
+
+    std::mt19937 gen(11);
+
+    // generated kernels vs scalar reference
+    {
+        const std::array<std::size_t, 3> shapes[] = {{48, 48, 48}, {1, 1, 1}, {5, 13, 7}, {48, 8, 48}, {17, 40, 3}, {13, 9, 47}, {7, 48, 20}};
+        for (const auto& [rows, cols, depth] : shapes) {
+            alignas(64) std::array<float, TILE * TILE> a{}, b{};
+            for (std::size_t r{}; r < rows; ++r)
+                for (std::size_t k{}; k < depth; ++k)
+                    a[r * TILE + k] = static_cast<float>((r * 7 + k * 3) % 11) - 5;
+            for (std::size_t k{}; k < depth; ++k)
+                for (std::size_t c{}; c < cols; ++c)
+                    b[k * TILE + c] = static_cast<float>((k * 5 + c) % 9) - 4;
+
+            constexpr std::size_t STRIDE = 96;
+            auto c = random_floats(TILE * STRIDE, gen);
+            auto expected = c;
+            for (std::size_t r{}; r < rows; ++r)
+                for (std::size_t j{}; j < cols; ++j) {
+                    float sum = expected[r * STRIDE + j];
+                    for (std::size_t k{}; k < depth; ++k)
+                        sum += a[r * TILE + k] * b[k * TILE + j];
+                    expected[r * STRIDE + j] = sum;
+                }
+
+            const jit::Kernel kernel = jit::kernel({rows, cols, depth});
+            assert(kernel != nullptr && "kernel generation failed");
+            kernel(a.data(), b.data(), c.data(), STRIDE * sizeof(float));
+            for (std::size_t r{}; r < rows; ++r)
+                for (std::size_t j{}; j < cols; ++j)
+                    assert(c[r * STRIDE + j] == expected[r * STRIDE + j] && "generated kernel check failed");
+        }
+    }
+
+    // kernels are cached by shape
+    {
+        const std::size_t before = jit::cached_kernels();
+        const jit::Kernel first = jit::kernel({31, 24, 5});
+        jit::kernel({32, 24, 5});
+        assert(jit::kernel({31, 24, 5}) == first && "cache returned a different kernel");
+        assert(jit::cached_kernels() == before + 2 && "cache size");
+    }
+
+    // Matrix products through the JIT match the template kernels
+    {
+        for (auto [m, n, k] : {std::array<std::size_t, 3>{100, 8, 77}, {50, 130, 5}, {96, 96, 96}, {3, 200, 150}}) {
+            auto A = Matrix<float>::make_random(m, k, -9, 9);
+            auto B = Matrix<float>::make_random(k, n, -9, 9);
+
+            Matrix<float> expected(m, n);
+            jit::set_enabled(false);
+            A.multiply(B, expected);
+            jit::set_enabled(true);
+
+            for (std::size_t threads : {1, 3}) {
+                Matrix<float> C(m, n);
+                A.multiply(B, C, Impl::TILED_REGISTERS, threads);
+                assert(C == expected && "JIT multiply check failed");
+            }
+        }
+    }
+
+    // narrow convolution output
+    {
+        const conv::Shape shape{.batch = 2, .in_channels = 3, .height = 12, .width = 12, .out_channels = 5, .kernel_h = 3, .kernel_w = 3, .pad_h = 1, .pad_w = 1};
+        const auto input = random_floats(shape.input_size(), gen);
+        const auto weights = random_floats(shape.weight_size(), gen);
+
+        std::vector<float> expected(shape.output_size()), output(shape.output_size());
+        jit::set_enabled(false);
+        conv::conv2d<float>(shape, conv::Format::NHWC, input, weights, expected);
+        jit::set_enabled(true);
+        conv::conv2d<float>(shape, conv::Format::NHWC, input, weights, output);
+        assert(output == expected && "JIT conv2d check failed");
+    }
+
+    // disabled JIT hands back no kernel
+    {
+        jit::set_enabled(false);
+        assert(jit::kernel({48, 48, 48}) == nullptr && "disabled JIT returned a kernel");
+        jit::set_enabled(true);
+    }
+
+    // a full cache stops generating and products fall back to the templates
+    {
+        for (std::size_t depth = 1; depth <= TILE && jit::cached_kernels() < jit::Cache::CAPACITY; ++depth)
+            for (std::size_t cols = 1; cols <= TILE && jit::cached_kernels() < jit::Cache::CAPACITY; ++cols)
+                jit::kernel({TILE, cols, depth});
+        assert(jit::cached_kernels() == jit::Cache::CAPACITY && "cache did not fill");
+        assert(jit::kernel({1, 1, 1}) != nullptr && "cached kernel lost");
+        assert(jit::kernel({2, 3, 4}) == nullptr && "full cache generated a kernel");
+        assert(jit::cached_kernels() == jit::Cache::CAPACITY && "cache grew past its capacity");
+
+        auto A = Matrix<float>::make_random(29, 31, -9, 9);
+        auto B = Matrix<float>::make_random(31, 37, -9, 9);
+        Matrix<float> expected(29, 37), C(29, 37);
+        A.multiply(B, expected, Impl::NAIVE);
+        A.multiply(B, C, Impl::TILED_REGISTERS);
+        assert(C == expected && "fallback multiply check failed");
+    }
+
+    return 0;
+}
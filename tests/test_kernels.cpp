@@ -0,0 +1,59 @@
+#include <array>
+#include <cassert>
+#include <vector>
+#include "../include/kernels.hpp"
+
+template<typename T>
+void check_transpose(std::size_t rows, std::size_t cols) {
+    const std::size_t src_stride = cols + 3, dst_stride = rows + 5;
+    std::vector<T> src(rows * src_stride), dst(cols * dst_stride, T{-1});
+    for (std::size_t i{}; i < src.size(); ++i)
+        src[i] = static_cast<T>(i);
+
+    kernels::transpose(src.data(), src_stride, dst.data(), dst_stride, rows, cols);
+    for (std::size_t r{}; r < rows; ++r)
+        for (std::size_t c{}; c < cols; ++c)
+            assert(dst[c * dst_stride + r] == src[r * src_stride + c] && "transpose mismatch");
+    for (std::size_t c{}; c < cols; ++c)
+        for (std::size_t r = rows; r < dst_stride; ++r)
+            assert(dst[c * dst_stride + r] == T{-1} && "transpose wrote past its extent");
+}
+
+template<typename T>
+void check_packs() {
+    static constexpr std::size_t TILE = 32, STRIDE = 96;
+    alignas(64) std::array<T, STRIDE * STRIDE> mat;
+    for (std::size_t i{}; i < mat.size(); ++i)
+        mat[i] = static_cast<T>(i % 1000 + 1);
+
+    for (auto [row_limit, col_limit] : {std::array<std::size_t, 2>{32, 32}, {4, 12}, {31, 29}, {1, 1}, {32, 8}}) {
+        alignas(64) kernels::Pack<T, TILE> linear, transposed;
+        linear.fill(T{-1});
+        transposed.fill(T{-1});
+        kernels::pack_tile_linearly<T, TILE>(mat.data(), STRIDE, 40, 32, row_limit, col_limit, linear);
+        kernels::pack_tile_transposed<T, TILE>(mat.data(), STRIDE, 40, 32, row_limit, col_limit, transposed);
+
+        for (std::size_t row{}; row < TILE; ++row) {
+            for (std::size_t col{}; col < TILE; ++col) {
+                const bool inside = row < row_limit && col < col_limit;
+                const T expected = inside ? mat[(row + 40) * STRIDE + col + 32] : T{};
+                assert(linear[row * TILE + col] == expected && "linear pack mismatch");
+                assert(transposed[col * TILE + row] == expected && "transposed pack mismatch");
+            }
+        }
+    }
+}
+
+int main() {
+    for (auto [rows, cols] : {std::array<std::size_t, 2>{8, 8}, {16, 24}, {13, 7}, {9, 17}, {1, 33}, {48, 48}}) {
+        check_transpose<float>(rows, cols);
+        check_transpose<int>(rows, cols);
+        check_transpose<double>(rows, cols);
+    }
+
+    check_packs<float>();
+    check_packs<int>();
+    check_packs<double>();
+
+    return 0;
+}
@@ -0,0 +1,63 @@
+#include <cassert>
+#include <vector>
+#include "../include/mat.hpp"
+
+// every tile of the grid gets a distinct rank in [0, grid^2)
+constexpr bool morton_is_dense(std::size_t grid) {
+    std::vector<bool> seen(grid * grid);
+    for (std::size_t row = 0; row < grid; ++row) {
+        for (std::size_t col = 0; col < grid; ++col) {
+            const std::size_t rank = layout::Morton::tile_rank(row, col, grid);
+            if (rank >= grid * grid || seen[rank])
+                return false;
+            seen[rank] = true;
+        }
+    }
+    return true;
+}
+
+template<typename Layout, std::size_t N>
+void check_layout() {
+    auto A = SquareMatrix<int, N>::make_random(0, 9);
+    auto B = SquareMatrix<int, N>::make_random(0, 9);
+    SquareMatrix<int, N> expected{};
+    A.multiply(B, expected, Impl::NAIVE);
+
+    const auto tiled_a = A.template to<Layout>();
+    const auto tiled_b = B.template to<Layout>();
+    for (std::size_t y = 0; y < N; ++y)
+        for (std::size_t x = 0; x < N; ++x)
+            assert(tiled_a.get(x, y) == A.get(x, y) && "conversion changed an element");
+
+    for (std::size_t threads : {1, 3}) {
+        SquareMatrix<int, N, Layout> C{};
+        tiled_a.multiply(tiled_b, C, Impl::TILED_REGISTERS, threads);
+        assert(C.template to<layout::RowMajor>() == expected && "tiled layout multiply mismatch");
+    }
+
+    SquareMatrix<int, N, Layout> naive{};
+    tiled_a.multiply(tiled_b, naive, Impl::NAIVE);
+    assert((SquareMatrix<int, N>(naive) == expected) && "tiled layout naive mismatch");
+}
+
+int main() {
+    static_assert(layout::Morton::tile_rank(0, 1, 4) == 1);
+    static_assert(layout::Morton::tile_rank(1, 0, 4) == 2);
+    static_assert(layout::Morton::tile_rank(0, 2, 4) == 4);
+    static_assert(layout::Morton::tile_rank(2, 0, 3) == 6);  // 3x3 grid skips the missing tiles
+    static_assert(morton_is_dense(1) && morton_is_dense(3) && morton_is_dense(5) && morton_is_dense(22));
+
+    check_layout<layout::BlockMajor, 52>();
+    check_layout<layout::BlockMajor, 192>();
+    check_layout<layout::Morton, 100>();
+    check_layout<layout::Morton, 244>();
+
+    // BlockMajor -> Morton -> RowMajor round trip
+    {
+        auto A = SquareMatrix<float, 148>::make_random(-9, 9);
+        const auto round_trip = A.to<layout::BlockMajor>().to<layout::Morton>().to<layout::RowMajor>();
+        assert(round_trip == A && "layout round trip");
+    }
+
+    return 0;
+}
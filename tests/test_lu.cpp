@@ -0,0 +1,132 @@
+#include <array>
+#include <cassert>
+#include <cmath>
+#include <cstddef>
+#include <tuple>
+#include <utility>
+#include "../include/mat.hpp"
+
+// Largest |x - y| over the logical N x N elements.
+template<typename T, std::size_t N>
+T max_difference(const SquareMatrix<T, N>& x, const SquareMatrix<T, N>& y) {
+    T worst{};
+    for (std::size_t row = 0; row < N; ++row)
+        for (std::size_t col = 0; col < N; ++col)
+            worst = std::max(worst, std::abs(x.get(col, row) - y.get(col, row)));
+    return worst;
+}
+
+template<typename T, std::size_t N>
+void check_lu(T tolerance) {
+    const auto A = SquareMatrix<T, N>::make_random(-9, 9);
+
+    SquareMatrix<T, N> factors{};
+    std::array<std::size_t, N> pivots{};
+    const bool regular = A.lu(factors, pivots, 2);
+    assert(regular && "random matrix reported singular");
+
+    // row `row` of P * A is row order[row] of A
+    std::array<std::size_t, N> order{};
+    for (std::size_t i = 0; i < N; ++i)
+        order[i] = i;
+    for (std::size_t i = 0; i < N; ++i)
+        std::swap(order[i], order[pivots[i]]);
+
+    // P * A == L * U, with every |L| <= 1 from partial pivoting
+    for (std::size_t row = 0; row < N; ++row) {
+        for (std::size_t col = 0; col < N; ++col) {
+            T product{};
+            for (std::size_t k = 0; k <= std::min(row, col); ++k)
+                product += (k == row ? T{1} : factors.get(k, row)) * factors.get(col, k);
+            assert(std::abs(product - A.get(col, order[row])) <= tolerance * N && "P * A != L * U");
+            if (col < row)
+                assert(std::abs(factors.get(col, row)) <= T{1} && "pivot was not the largest");
+        }
+    }
+
+    // A * x == b for N right-hand sides
+    const auto B = SquareMatrix<T, N>::make_random(-9, 9);
+    auto X = B;
+    factors.lu_solve(pivots, X);
+    SquareMatrix<T, N> residual{};
+    A.multiply(X, residual, Impl::NAIVE);
+    assert(max_difference(residual, B) <= tolerance * N * 100 && "lu_solve residual too large");
+}
+
+template<typename T, std::size_t N>
+void check_trsm(T tolerance) {
+    // triangles from a pivoted LU stay well conditioned in practice
+    const auto A = SquareMatrix<T, N>::make_random(-9, 9);
+    SquareMatrix<T, N> factors{};
+    std::array<std::size_t, N> pivots{};
+    A.lu(factors, pivots);
+    const auto B = SquareMatrix<T, N>::make_random(-9, 9);
+
+    // U is only well conditioned with its own diagonal: with ones instead,
+    // its unbounded entries make X overflow in float
+    const std::array<std::pair<Triangle, Diagonal>, 3> cases{{
+        {Triangle::LOWER, Diagonal::UNIT},
+        {Triangle::LOWER, Diagonal::NON_UNIT},
+        {Triangle::UPPER, Diagonal::NON_UNIT},
+    }};
+    for (const auto& [triangle, diagonal] : cases) {
+        auto X = B;
+        factors.trsm(X, triangle, diagonal, 3);
+
+        // T * X == B, multiplying by the triangle explicitly; the error
+        // bound scales with |T| * |X|
+        T x_max{}, t_max{1};
+        for (std::size_t row = 0; row < N; ++row)
+            for (std::size_t col = 0; col < N; ++col) {
+                x_max = std::max(x_max, std::abs(X.get(col, row)));
+                t_max = std::max(t_max, std::abs(factors.get(col, row)));
+            }
+        const T scale = x_max * t_max;
+
+        for (std::size_t row = 0; row < N; ++row) {
+            for (std::size_t col = 0; col < N; ++col) {
+                T sum{};
+                for (std::size_t k = 0; k < N; ++k) {
+                    const bool inside = triangle == Triangle::LOWER ? k <= row : k >= row;
+                    if (!inside)
+                        continue;
+                    const T t = k == row && diagonal == Diagonal::UNIT ? T{1} : factors.get(k, row);
+                    sum += t * X.get(col, k);
+                }
+                assert(std::abs(sum - B.get(col, row)) <= tolerance * N * scale && "T * X != B");
+            }
+        }
+    }
+}
+
+void check_singular() {
+    // rank 1: every row a multiple of the first
+    constexpr std::size_t N = 8;
+    std::array<double, N * N> values{};
+    for (std::size_t row = 0; row < N; ++row)
+        for (std::size_t col = 0; col < N; ++col)
+            values[row * N + col] = double(row + 1) * double(col % 3 + 1);
+    const auto A = std::apply([](auto... v) { return SquareMatrix<double, N>(v...); }, values);
+
+    SquareMatrix<double, N> factors{};
+    std::array<std::size_t, N> pivots{};
+    const bool rank_one_regular = A.lu(factors, pivots);
+    assert(!rank_one_regular && "rank-1 matrix not reported singular");
+
+    const auto zero = SquareMatrix<double, 100>::make_random(0, 0);
+    SquareMatrix<double, 100> zero_factors{};
+    std::array<std::size_t, 100> zero_pivots{};
+    const bool zero_regular = zero.lu(zero_factors, zero_pivots, 2);
+    assert(!zero_regular && "zero matrix not reported singular");
+}
+
+int main() {
+    check_lu<double, 8>(1e-12);
+    check_lu<double, 100>(1e-12);
+    check_lu<double, 144>(1e-12);
+    check_lu<float, 92>(1e-4f);
+    check_trsm<double, 100>(1e-12);
+    check_trsm<float, 52>(1e-4f);
+    check_singular();
+    return 0;
+}
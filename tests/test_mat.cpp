@@ -63,5 +63,21 @@ int main() {
         }
     }
 
+    // syrk vs multiply with the transpose
+    {
+        constexpr std::size_t MAT_SIZE = 100;
+        auto A = SquareMatrix<int, MAT_SIZE>::make_random(0, 9);
+        SquareMatrix<int, MAT_SIZE> At{};
+        for (std::size_t y = 0; y < MAT_SIZE; ++y)
+            for (std::size_t x = 0; x < MAT_SIZE; ++x)
+                At.data()[y * At.stride() + x] = A.get(y, x);
+
+        SquareMatrix<int, MAT_SIZE> full{}; A.multiply(At, full, Impl::NAIVE);
+        SquareMatrix<int, MAT_SIZE> lower{}; A.syrk(lower, Triangle::LOWER, 2);
+        for (std::size_t y = 0; y < MAT_SIZE; ++y)
+            for (std::size_t x = 0; x < MAT_SIZE; ++x)
+                assert(lower.get(x, y) == (x <= y ? full.get(x, y) : 0) && "syrk check failed");
+    }
+
     return 0;
 }
@@ -0,0 +1,65 @@
+#include <cassert>
+#include "../include/matrix.hpp"
+
+int main() {
+    // padding follows the register tile
+    {
+        Matrix<int> A(50, 7);
+        assert(A.rows() == 50 && A.cols() == 7 && "extents");
+        assert(A.padded_rows() == 96 && A.stride() == 48 && "padding");
+    }
+
+    // rectangular tiled vs naive
+    {
+        for (auto [m, n, k] : {std::array<std::size_t, 3>{4, 4, 4}, {50, 7, 100}, {97, 145, 33}, {48, 96, 144}}) {
+            auto A = Matrix<int>::make_random(m, k, 0, 9);
+            auto B = Matrix<int>::make_random(k, n, 0, 9);
+
+            Matrix<int> C1(m, n); A.multiply(B, C1, Impl::NAIVE);
+            Matrix<int> C2(m, n); A.multiply(B, C2, Impl::TILED_REGISTERS);
+            assert(C1 == C2 && "rectangular check failed");
+
+            // out is overwritten, not accumulated into
+            A.multiply(B, C2, Impl::TILED_REGISTERS);
+            assert(C1 == C2 && "repeated multiply accumulated");
+        }
+    }
+
+    // threaded tiled vs naive
+    {
+        auto A = Matrix<int>::make_random(200, 130, 0, 9);
+        auto B = Matrix<int>::make_random(130, 90, 0, 9);
+
+        Matrix<int> C1(200, 90); A.multiply(B, C1, Impl::NAIVE);
+        for (std::size_t threads : {2, 3, 8}) {
+            Matrix<int> C2(200, 90); A.multiply(B, C2, Impl::TILED_REGISTERS, threads);
+            assert(C1 == C2 && "threaded check failed");
+        }
+    }
+
+    // syrk writes one triangle of A * A^T and zeros the other
+    {
+        for (auto [m, k] : {std::array<std::size_t, 2>{5, 3}, {100, 70}, {150, 200}}) {
+            auto A = Matrix<int>::make_random(m, k, -9, 9);
+            Matrix<int> At(k, m);
+            for (std::size_t y = 0; y < m; ++y)
+                for (std::size_t x = 0; x < k; ++x)
+                    At.set(y, x, A.get(x, y));
+            Matrix<int> full(m, m); A.multiply(At, full, Impl::NAIVE);
+
+            for (auto triangle : {Triangle::LOWER, Triangle::UPPER}) {
+                for (std::size_t threads : {1, 3}) {
+                    Matrix<int> C(m, m);
+                    A.syrk(C, triangle, threads);
+                    for (std::size_t y = 0; y < m; ++y)
+                        for (std::size_t x = 0; x < m; ++x) {
+                            const bool inside = triangle == Triangle::LOWER ? x <= y : x >= y;
+                            assert(C.get(x, y) == (inside ? full.get(x, y) : 0) && "syrk check failed");
+                        }
+                }
+            }
+        }
+    }
+
+    return 0;
+}
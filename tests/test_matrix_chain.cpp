@@ -0,0 +1,91 @@
+#include <array>
+#include <cassert>
+#include "../include/matrix_chain.hpp"
+
+template<typename T>
+Matrix<T> naive(const Matrix<T>& a, const Matrix<T>& b) {
+    Matrix<T> out(a.rows(), b.cols());
+    a.multiply(b, out, Impl::NAIVE);
+    return out;
+}
+
+int main() {
+    // rectangular chain: order follows the padded extents, result matches
+    {
+        auto A = Matrix<int>::make_random(10, 300, 0, 5);
+        auto B = Matrix<int>::make_random(300, 7, 0, 5);
+        auto C = Matrix<int>::make_random(7, 200, 0, 5);
+        auto D = Matrix<int>::make_random(200, 60, 0, 5);
+
+        const auto chain = A * B * C * D;
+        assert(chain.rows() == 10 && chain.cols() == 60 && "chain extents");
+        assert(chain.order() == "((M0 M1) (M2 M3))" && "cheapest order");
+
+        const Matrix<int> expected = naive(naive(naive(A, B), C), D);
+        const Matrix<int> R = chain;
+        assert(R == expected && "chain result mismatch");
+
+        // right-heavy shapes pick the other side
+        auto E = Matrix<int>::make_random(300, 300, 0, 5);
+        auto F = Matrix<int>::make_random(300, 20, 0, 5);
+        assert((E * E * F).order() == "(M0 (M1 M2))" && "right-associated order");
+    }
+
+    // workspace buffers are reused across evaluations
+    {
+        auto A = Matrix<int>::make_random(100, 100, 0, 1);
+        auto B = Matrix<int>::make_random(100, 100, 0, 1);
+
+        ChainWorkspace<int> workspace;
+        Matrix<int> out(100, 100);
+        const auto chain = A * B * A * B * A;
+        chain.evaluate(out, workspace);
+        const std::size_t allocations = workspace.allocations();
+        assert(workspace.buffers() <= 2 && "intermediates were not recycled");
+
+        chain.evaluate(out, workspace, 3);
+        assert(workspace.allocations() == allocations && "second evaluation allocated");
+
+        const Matrix<int> expected = naive(naive(naive(naive(A, B), A), B), A);
+        assert(out == expected && "five-operand chain mismatch");
+    }
+
+    // a balanced order holds a buffer per level of the plan tree, plus one
+    {
+        auto A = Matrix<int>::make_random(40, 140, 0, 3);
+        auto B = Matrix<int>::make_random(140, 90, 0, 3);
+        auto C = Matrix<int>::make_random(90, 90, 0, 3);
+        auto D = Matrix<int>::make_random(90, 8, 0, 3);
+        auto E = Matrix<int>::make_random(8, 90, 0, 3);
+        auto F = Matrix<int>::make_random(90, 8, 0, 3);
+        auto G = Matrix<int>::make_random(8, 40, 0, 3);
+        auto H = Matrix<int>::make_random(40, 8, 0, 3);
+
+        const auto chain = A * B * C * D * E * F * G * H;
+        assert(chain.order() == "(((M0 M1) (M2 M3)) ((M4 M5) (M6 M7)))" && "balanced order");
+
+        ChainWorkspace<int> workspace;
+        Matrix<int> out(40, 8);
+        chain.evaluate(out, workspace);
+        assert(workspace.buffers() <= 4 && "more buffers than the plan height allows");
+
+        const Matrix<int> expected = naive(naive(naive(A, B), naive(C, D)), naive(naive(E, F), naive(G, H)));
+        assert(out == expected && "balanced chain mismatch");
+    }
+
+    // SquareMatrix chain written straight into the destination
+    {
+        auto A = SquareMatrix<int, 52>::make_random(0, 5);
+        auto B = SquareMatrix<int, 52>::make_random(0, 5);
+        auto C = SquareMatrix<int, 52>::make_random(0, 5);
+
+        SquareMatrix<int, 52> AB{}, expected{};
+        A.multiply(B, AB, Impl::NAIVE);
+        AB.multiply(C, expected, Impl::NAIVE);
+
+        SquareMatrix<int, 52> R = A * B * C;
+        assert(R == expected && "SquareMatrix chain mismatch");
+    }
+
+    return 0;
+}
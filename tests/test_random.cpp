@@ -0,0 +1,74 @@
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <set>
+#include "../include/matrix.hpp"
+
+void check_philox() {
+    // known answers from the Random123 distribution (kat_vectors)
+    assert((philox::generate({0, 0, 0, 0}, 0) == philox::Block{0x6627e8d5, 0xe169c58d, 0xbc57ac4c, 0x9b00dbd8}));
+    assert((philox::generate({0xffffffff, 0xffffffff, 0xffffffff, 0xffffffff}, 0xffffffffffffffff)
+        == philox::Block{0x408f276d, 0x41c83b0e, 0xa20bc7c6, 0x6d5451fd}));
+    assert((philox::generate({0x243f6a88, 0x85a308d3, 0x13198a2e, 0x03707344}, 0x299f31d0a4093822)
+        == philox::Block{0xd16cfe09, 0x94fdcceb, 0x5001e420, 0x24126ea1}));
+
+    // the batched generator agrees with the reference, lane by lane
+    std::uint64_t col_blocks[philox::LANES], rows[philox::LANES];
+    for (std::size_t i{}; i < philox::LANES; ++i) {
+        col_blocks[i] = 0x100000000ull * i + 7 * i;
+        rows[i] = 0x300000000ull + 13 * i;
+    }
+    std::uint32_t out[4][philox::LANES];
+    philox::generate(col_blocks, rows, 42, out);
+    for (std::size_t i{}; i < philox::LANES; ++i) {
+        const philox::Block counter{
+            static_cast<std::uint32_t>(col_blocks[i]), static_cast<std::uint32_t>(rows[i]),
+            static_cast<std::uint32_t>(col_blocks[i] >> 32), static_cast<std::uint32_t>(rows[i] >> 32),
+        };
+        const auto expected = philox::generate(counter, 42);
+        for (std::size_t l{}; l < 4; ++l)
+            assert(out[l][i] == expected[l] && "batched Philox mismatch");
+    }
+}
+
+template<std::size_t N>
+void check_square() {
+    using Square = SquareMatrix<int, N>;
+    const auto reference = Square::make_random(-5, 5, 1234, 1);
+
+    // independent of the thread count, deterministic, seed dependent
+    assert(Square::make_random(-5, 5, 1234, 3) == reference && "thread count changed the matrix");
+    assert(Square::make_random(-5, 5, 1234, 0) == reference && "thread count changed the matrix");
+    assert(!(Square::make_random(-5, 5, 1235, 1) == reference) && "seed was ignored");
+
+    // every value in range and every value drawn; the transposed copy agrees
+    std::set<int> seen;
+    for (std::size_t y = 0; y < N; ++y) {
+        for (std::size_t x = 0; x < N; ++x) {
+            const int value = reference.get(x, y);
+            assert(value >= -5 && value <= 5 && "value out of range");
+            assert(reference.data_transposed()[x * Square::stride() + y] == value && "transposed copy mismatch");
+            seen.insert(value);
+        }
+    }
+    assert(seen.size() == 11 && "a value in range never appeared");
+
+    // tiled layouts hold the same elements, and Matrix draws the same stream
+    const auto tiled = SquareMatrix<int, N, layout::Morton>::make_random(-5, 5, 1234, 2);
+    const auto runtime = Matrix<int>::make_random(N, N - 3, -5, 5, 1234, 2);
+    for (std::size_t y = 0; y < N; ++y) {
+        for (std::size_t x = 0; x < N; ++x) {
+            assert(tiled.get(x, y) == reference.get(x, y) && "tiled layout mismatch");
+            if (x < N - 3)
+                assert(runtime.get(x, y) == reference.get(x, y) && "Matrix mismatch");
+        }
+    }
+}
+
+int main() {
+    check_philox();
+    check_square<8>();
+    check_square<100>();
+    check_square<144>();
+    return 0;
+}
@@ -0,0 +1,52 @@
+#include <array>
+#include <cassert>
+#include <future>
+#include <vector>
+#include "../include/gemm_scheduler.hpp"
+
+int main() {
+    GemmScheduler scheduler(4);
+
+    // mixed small and tiled jobs, all priorities
+    {
+        struct Job {
+            Matrix<int> a, b, expected, out;
+        };
+        std::vector<Job> jobs;
+        for (auto [m, n, k] : {std::array<std::size_t, 3>{7, 9, 5}, {300, 500, 260}, {50, 50, 50}, {100, 1000, 200}}) {
+            Job job{Matrix<int>::make_random(m, k, 0, 9), Matrix<int>::make_random(k, n, 0, 9), {m, n}, {m, n}};
+            job.a.multiply(job.b, job.expected, Impl::NAIVE);
+            jobs.push_back(std::move(job));
+        }
+
+        std::vector<std::future<void>> futures;
+        for (std::size_t i = 0; i < jobs.size(); ++i)
+            futures.push_back(scheduler.submit(jobs[i].a, jobs[i].b, jobs[i].out, static_cast<Priority>(i % 3)));
+        for (auto& f : futures)
+            f.get();
+
+        for (const auto& job : jobs)
+            assert(job.out == job.expected && "scheduled multiply mismatch");
+    }
+
+    // SquareMatrix overload, output is overwritten
+    {
+        auto A = SquareMatrix<int, 100>::make_random(0, 9);
+        auto B = SquareMatrix<int, 100>::make_random(0, 9);
+        SquareMatrix<int, 100> C1{}; A.multiply(B, C1, Impl::NAIVE);
+        SquareMatrix<int, 100> C2{};
+        scheduler.submit(A, B, C2, Priority::HIGH).get();
+        scheduler.submit(A, B, C2, Priority::HIGH).get();
+        assert(C1 == C2 && "SquareMatrix scheduled multiply mismatch");
+    }
+
+    // metrics drain back to zero
+    {
+        const auto metrics = scheduler.metrics();
+        for (std::size_t p = 0; p < PRIORITY_COUNT; ++p)
+            assert(metrics.queued_jobs[p] == 0 && metrics.pending_tiles[p] == 0 && "queues not drained");
+        assert(metrics.completed_jobs == 6 && "completed job count");
+    }
+
+    return 0;
+}
@@ -0,0 +1,77 @@
+#include <array>
+#include <cassert>
+#include <cstddef>
+#include <limits>
+#include "../include/mat.hpp"
+#include "../include/matrix.hpp"
+
+// The register kernel against the scalar loop, over ragged shapes so the
+// S::zero padding of the depth and the cleared padding of out both matter.
+template<typename S, typename T>
+void check_runtime(T lower, T upper) {
+    for (auto [m, n, k] : {std::array<std::size_t, 3>{3, 5, 7}, {50, 7, 100}, {97, 145, 33}}) {
+        const auto A = Matrix<T>::make_random(m, k, lower, upper, 7);
+        const auto B = Matrix<T>::make_random(k, n, lower, upper, 8);
+        Matrix<T> expected(m, n), out(m, n);
+        A.template multiply_over<S>(B, expected, Impl::NAIVE);
+
+        for (std::size_t threads : {1, 3}) {
+            A.template multiply_over<S>(B, out, Impl::TILED_REGISTERS, threads);
+            assert(out == expected && "semiring product mismatch");
+            for (std::size_t y = 0; y < out.padded_rows(); ++y)
+                for (std::size_t x = (y < m ? n : 0); x < out.stride(); ++x)
+                    assert(out.data()[y * out.stride() + x] == T{} && "padding not cleared");
+        }
+    }
+}
+
+// Repeated min-plus squaring of a ring's distance matrix converges to the
+// shortest distances around it.
+template<typename T, std::size_t N>
+void check_shortest_paths() {
+    const T none = semiring::MinPlus::zero<T>();
+    Matrix<T> distances(N, N);
+    for (std::size_t y = 0; y < N; ++y)
+        for (std::size_t x = 0; x < N; ++x)
+            distances.set(x, y, x == y ? T{} : x == (y + 1) % N ? T{1} : none);
+
+    Matrix<T> next(N, N);
+    for (std::size_t hops = 1; hops < N; hops *= 2) {
+        distances.template multiply_over<semiring::MinPlus>(distances, next, Impl::TILED_REGISTERS, 2);
+        std::swap(distances, next);
+    }
+    for (std::size_t y = 0; y < N; ++y)
+        for (std::size_t x = 0; x < N; ++x)
+            assert(distances.get(x, y) == T((x + N - y) % N) && "wrong shortest distance");
+}
+
+template<typename S, std::size_t N>
+void check_square() {
+    const auto A = SquareMatrix<int, N>::make_random(0, 1, 3);
+    const auto B = SquareMatrix<int, N>::make_random(0, 1, 4);
+    SquareMatrix<int, N> out{};
+    A.template multiply_over<S>(B, out, 2);
+
+    for (std::size_t y = 0; y < N; ++y) {
+        for (std::size_t x = 0; x < N; ++x) {
+            int expected = S::template zero<int>();
+            for (std::size_t k = 0; k < N; ++k)
+                expected = S::add(expected, S::mul(A.get(k, y), B.get(x, k)));
+            assert(out.get(x, y) == expected && "square semiring product mismatch");
+        }
+    }
+}
+
+int main() {
+    check_runtime<semiring::MinPlus, float>(0.0f, 100.0f);
+    check_runtime<semiring::MaxPlus, float>(-50.0f, 50.0f);
+    check_runtime<semiring::MinPlus, int>(0, 1000);
+    check_runtime<semiring::MaxPlus, int>(-1000, 1000);
+    check_runtime<semiring::Boolean, int>(0, 1);
+    check_runtime<semiring::PlusTimes, int>(-10, 10);
+    check_shortest_paths<float, 60>();
+    check_shortest_paths<int, 100>();
+    check_square<semiring::Boolean, 52>();
+    check_square<semiring::MinPlus, 100>();
+    return 0;
+}
@@ -0,0 +1,44 @@
+#include <cassert>
+#include <cstddef>
+#include <span>
+#include <vector>
+#include "../include/matrix.hpp"
+#include "../include/stream.hpp"
+
+template<typename T>
+void check_stream(std::size_t rows, std::size_t depth, std::size_t cols, std::size_t threads) {
+    const auto A = Matrix<T>::make_random(rows, depth, -9, 9, 7);
+    const auto B = Matrix<T>::make_random(depth, cols, -9, 9, 8);
+    Matrix<T> expected(rows, cols);
+    A.multiply(B, expected, Impl::NAIVE);
+
+    const stream::RowBlockGemm<T> gemm(B.data(), B.stride(), depth, cols);
+
+    // blocks of every awkward height, each answered on its own
+    std::size_t row{}, height{1};
+    std::vector<T> a_rows, c_rows;
+    while (row < rows) {
+        const std::size_t block = std::min(height, rows - row);
+        a_rows.resize(block * depth);
+        for (std::size_t r{}; r < block; ++r)
+            for (std::size_t k{}; k < depth; ++k)
+                a_rows[r * depth + k] = A.get(k, row + r);
+
+        c_rows.assign(block * cols, T{-1});
+        gemm.push(std::span<const T>(a_rows), std::span<T>(c_rows), threads);
+        for (std::size_t r{}; r < block; ++r)
+            for (std::size_t x{}; x < cols; ++x)
+                assert(c_rows[r * cols + x] == expected.get(x, row + r) && "streamed rows mismatch");
+
+        row += block;
+        height = height * 3 % 61 + 1;
+    }
+}
+
+int main() {
+    check_stream<float>(200, 100, 70, 1);
+    check_stream<float>(97, 48, 145, 3);
+    check_stream<int>(130, 7, 5, 2);
+    check_stream<double>(60, 200, 96, 1);
+    return 0;
+}
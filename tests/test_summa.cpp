@@ -0,0 +1,75 @@
+#include <array>
+#include <cassert>
+#include <string>
+#include <sys/wait.h>
+#include <unistd.h>
+#include "../include/shm_transport.hpp"
+
+// Forks one process per rank; each checks its C block against the product
+// computed before the fork.
+bool run_grid(summa::Grid grid, std::size_t m, std::size_t n, std::size_t k) {
+    const auto a = Matrix<int>::make_random(m, k, -9, 9);
+    const auto b = Matrix<int>::make_random(k, n, -9, 9);
+    Matrix<int> expected(m, n);
+    a.multiply(b, expected, Impl::NAIVE);
+
+    const summa::Distribution distribution(grid, m, n, k);
+    const std::string name = "/gemm-test-summa-" + std::to_string(getpid());
+
+    std::vector<pid_t> children;
+    for (std::size_t rank = 0; rank < grid.size(); ++rank) {
+        const pid_t pid = fork();
+        if (pid != 0) {
+            children.push_back(pid);
+            continue;
+        }
+
+        summa::ShmTransport transport(name, rank, grid.size(), distribution.max_message_bytes<int>());
+        const auto rows = distribution.c_rows(rank);
+        const auto cols = distribution.c_cols(rank);
+        const auto a_local = summa::slice(a, rows, distribution.a_cols(rank));
+        const auto b_local = summa::slice(b, distribution.b_rows(rank), cols);
+
+        Matrix<int> c_local(rows.size(), cols.size());
+        const auto timings = summa::multiply(transport, distribution, a_local, b_local, c_local, rank % 2 + 1);
+
+        const bool ok = c_local == summa::slice(expected, rows, cols) && timings.size() == distribution.panels().size();
+        _exit(ok ? 0 : 1);
+    }
+
+    bool ok = true;
+    for (pid_t child : children) {
+        int status{};
+        waitpid(child, &status, 0);
+        ok = ok && WIFEXITED(status) && WEXITSTATUS(status) == 0;
+    }
+    return ok;
+}
+
+int main() {
+    // partition follows the register tile
+    {
+        const auto bounds = summa::partition(100, 2);
+        assert(bounds == (std::vector<std::size_t>{0, 48, 100}) && "tile-aligned partition");
+    }
+
+    // panels are cut where either A's or B's ownership changes
+    {
+        const summa::Distribution distribution({2, 3}, 96, 96, 300);
+        for (const auto& panel : distribution.panels())
+            assert(panel.k.begin % 48 == 0 && panel.k.size() > 0 && "panel bounds");
+        assert(distribution.panels().back().k.end == 300 && "panels cover K");
+    }
+
+    // checked outside assert so the ranks are forked in Release builds too
+    if (!run_grid({2, 2}, 100, 130, 200))
+        return 1;
+    if (!run_grid({1, 3}, 50, 300, 97))
+        return 1;
+    if (!run_grid({3, 1}, 300, 20, 150))
+        return 1;
+    if (!run_grid({2, 3}, 250, 170, 333))
+        return 1;
+
+    return 0;
+}
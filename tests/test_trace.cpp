@@ -0,0 +1,40 @@
+#include <cassert>
+#include <cstdio>
+#include "../include/mat.hpp"
+
+int main() {
+    static_assert(trace::ENABLED, "test must be built with GEMM_TRACE");
+
+    // spans recorded around the register-blocked multiply
+    {
+        trace::reset();
+
+        auto A = SquareMatrix<int, 96>::make_random(0, 9);
+        auto B = SquareMatrix<int, 96>::make_random(0, 9);
+        SquareMatrix<int, 96> C{}; A.multiply(B, C, Impl::TILED_REGISTERS);
+
+        const auto histograms = trace::merged_histograms();
+        auto count = [&](trace::Span s) { return histograms[static_cast<std::size_t>(s)].count; };
+
+        // 96 = 2 tiles of 48: 2 rows, 4 panels, 4 + 8 packs, 8 microkernels
+        assert(count(trace::Span::MULTIPLY)    == 1);
+        assert(count(trace::Span::TILE_ROW)    == 2);
+        assert(count(trace::Span::TILE_PANEL)  == 4);
+        assert(count(trace::Span::PACK)        == 12);
+        assert(count(trace::Span::MICROKERNEL) == 8);
+        assert(count(trace::Span::C_LOAD) == count(trace::Span::C_STORE));
+        assert(count(trace::Span::C_LOAD) > 0);
+    }
+
+    // export
+    {
+        const bool chrome = trace::write_chrome_trace("test_trace.json");
+        const bool histograms = trace::write_histograms("test_trace_histograms.json");
+        assert(chrome && "chrome trace export failed");
+        assert(histograms && "histogram export failed");
+        std::remove("test_trace.json");
+        std::remove("test_trace_histograms.json");
+    }
+
+    return 0;
+}